@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "hf_hierarchy.h"
+
+#define NODE_COUNT 200000
+#define FRAME_COUNT 20
+#define DIRTY_PER_FRAME (NODE_COUNT / 20)
+#define ROOT_CHANCE 500//one node in ROOT_CHANCE starts a new tree
+#define TOLERANCE 1e-4f
+
+#if defined(_OPENMP)
+#include <omp.h>
+static double now_ms(void) {
+    return 1000.0 * omp_get_wtime();
+}
+#else
+static double now_ms(void) {
+    return 1000.0 * (double)clock() / CLOCKS_PER_SEC;
+}
+#endif
+
+static int failures = 0;
+
+static float random_float(void) {
+    return 2.f * (float)rand() / (float)RAND_MAX - 1.f;
+}
+
+//rotation about x, y and z followed by a translation, so world transforms stay bounded along deep chains
+static void random_local(hf_mat4f out) {
+    float a = 3.14159265f * random_float();
+    float b = 3.14159265f * random_float();
+    float c = 3.14159265f * random_float();
+    float ca = cosf(a), sa = sinf(a), cb = cosf(b), sb = sinf(b), cc = cosf(c), sc = sinf(c);
+    hf_mat4f local = {
+        { cc * cb, cc * sb * sa - sc * ca, cc * sb * ca + sc * sa, random_float() },
+        { sc * cb, sc * sb * sa + cc * ca, sc * sb * ca - cc * sa, random_float() },
+        { -sb, cb * sa, cb * ca, random_float() },
+        { 0.f, 0.f, 0.f, 1.f },
+    };
+    memcpy(out, local, sizeof(local));
+}
+
+//random forest in depth-first preorder: the parent of a node is the previous node or one of its ancestors
+static void random_parents(int* parents, size_t count) {
+    int* chain = malloc(sizeof(int) * count);
+    size_t depth = 0;
+    for(size_t i = 0; i < count; i++) {
+        size_t pops = (size_t)(rand() % 4);
+        depth = pops < depth ? depth - pops : 0;
+        if(rand() % ROOT_CHANCE == 0) {
+            depth = 0;
+        }
+        parents[i] = depth > 0 ? chain[depth - 1] : -1;
+        chain[depth++] = (int)i;
+    }
+    free(chain);
+}
+
+//the full recompute the incremental update replaces, parents always come before their children
+static void recompute_all(hf_mat4f* locals, int* parents, hf_mat4f* worlds, size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        if(parents[i] < 0) {
+            memcpy(worlds[i], locals[i], sizeof(worlds[0]));
+        }
+        else {
+            hf_mat4f_multiply_mat4f(worlds[parents[i]], locals[i], worlds[i]);
+        }
+    }
+}
+
+static float max_difference(hf_mat4f* a, hf_mat4f* b, size_t count) {
+    float diff = 0.f;
+    for(size_t n = 0; n < count; n++) {
+        for(int i = 0; i < 4; i++) {
+            for(int j = 0; j < 4; j++) {
+                float d = fabsf(a[n][i][j] - b[n][i][j]);
+                diff = d > diff ? d : diff;
+            }
+        }
+    }
+    return diff;
+}
+
+//nodes below a changed node, including itself, are the ones an update recomputes
+static size_t expected_recomputed(int* parents, unsigned char* changed, size_t count) {
+    unsigned char* stale = malloc(count);
+    size_t total = 0;
+    for(size_t i = 0; i < count; i++) {
+        stale[i] = changed[i] || (parents[i] >= 0 && stale[parents[i]]);
+        total += stale[i];
+    }
+    free(stale);
+    return total;
+}
+
+static void expect(const char* what, size_t value, size_t expected) {
+    if(value != expected) {
+        printf("FAILED: %s, %zu instead of %zu\n", what, value, expected);
+        failures++;
+    }
+}
+
+int main(void) {
+    hf_hierarchy h;
+    h.count = NODE_COUNT;
+    h.parents = malloc(sizeof(int) * NODE_COUNT);
+    h.subtree_sizes = malloc(sizeof(int) * NODE_COUNT);
+    h.dirty = malloc(NODE_COUNT);
+    h.dirty_roots = malloc(sizeof(int) * NODE_COUNT);
+    h.locals = malloc(sizeof(hf_mat4f) * NODE_COUNT);
+    h.worlds = malloc(sizeof(hf_mat4f) * NODE_COUNT);
+    hf_mat4f* reference = malloc(sizeof(hf_mat4f) * NODE_COUNT);
+    unsigned char* changed = malloc(NODE_COUNT);
+
+    random_parents(h.parents, NODE_COUNT);
+    for(size_t i = 0; i < NODE_COUNT; i++) {
+        random_local(h.locals[i]);
+    }
+    hf_hierarchy_build(&h);
+    expect("first update", hf_hierarchy_update(&h), NODE_COUNT);
+    expect("update without changes", hf_hierarchy_update(&h), 0);
+
+    double incremental_ms = 0.0, full_ms = 0.0, reference_ms = 0.0;
+    size_t recomputed = 0;
+    float diff = 0.f;
+    for(int frame = 0; frame < FRAME_COUNT; frame++) {
+        memset(changed, 0, NODE_COUNT);
+        for(int n = 0; n < DIRTY_PER_FRAME; n++) {
+            int node = rand() % NODE_COUNT;
+            hf_mat4f local;
+            random_local(local);
+            hf_hierarchy_set_local(&h, node, local);
+            changed[node] = 1;
+        }
+        size_t expected = expected_recomputed(h.parents, changed, NODE_COUNT);
+
+        double start = now_ms();
+        size_t count = hf_hierarchy_update(&h);
+        incremental_ms += now_ms() - start;
+        expect("incremental update", count, expected);
+        recomputed += count;
+
+        start = now_ms();
+        recompute_all(h.locals, h.parents, reference, NODE_COUNT);
+        reference_ms += now_ms() - start;
+        float d = max_difference(h.worlds, reference, NODE_COUNT);
+        diff = d > diff ? d : diff;
+
+        expect("update without changes", hf_hierarchy_update(&h), 0);
+
+        memset(h.dirty, 1, NODE_COUNT);
+        start = now_ms();
+        count = hf_hierarchy_update(&h);
+        full_ms += now_ms() - start;
+        expect("full update", count, NODE_COUNT);
+        d = max_difference(h.worlds, reference, NODE_COUNT);
+        diff = d > diff ? d : diff;
+    }
+
+#if defined(_OPENMP)
+    printf("%d nodes, %d changed per frame, %d openmp threads\n", NODE_COUNT, DIRTY_PER_FRAME, omp_get_max_threads());
+#else
+    printf("%d nodes, %d changed per frame\n", NODE_COUNT, DIRTY_PER_FRAME);
+#endif
+    printf("%-32s %10.3f ms/frame, %zu nodes recomputed per frame\n", "incremental update", incremental_ms / FRAME_COUNT, recomputed / FRAME_COUNT);
+    printf("%-32s %10.3f ms/frame\n", "full update", full_ms / FRAME_COUNT);
+    printf("%-32s %10.3f ms/frame\n", "full recompute by hand", reference_ms / FRAME_COUNT);
+    printf("max difference to the full recompute: %g\n", diff);
+
+    free(h.parents);
+    free(h.subtree_sizes);
+    free(h.dirty);
+    free(h.dirty_roots);
+    free(h.locals);
+    free(h.worlds);
+    free(reference);
+    free(changed);
+
+    if(diff > TOLERANCE) {
+        printf("FAILED: difference above %g\n", TOLERANCE);
+        failures++;
+    }
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,202 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "hf_mat.h"
+
+#define ACCURACY_COUNT 100000
+#define TIMING_COUNT 1000000
+#define EIGEN_TOLERANCE 1e-5
+#define ORTHO_TOLERANCE 1e-5
+#define POLAR_TOLERANCE 1e-5
+
+static int failures = 0;
+
+static float random_float(void) {
+    return 2.f * (float)rand() / (float)RAND_MAX - 1.f;
+}
+
+static void random_symmetric(hf_mat3f mat) {
+    float scale = rand() % 3 == 0 ? 100.f : 1.f;
+    for(int i = 0; i < 3; i++) {
+        for(int j = i; j < 3; j++) {
+            mat[i][j] = mat[j][i] = random_float() * scale;
+        }
+    }
+}
+
+static void random_general(hf_mat3f mat) {
+    for(int i = 0; i < 3; i++) {
+        for(int j = 0; j < 3; j++) {
+            mat[i][j] = random_float();
+        }
+    }
+}
+
+static double max_abs(hf_mat3f mat) {
+    double m = 0.0;
+    for(int i = 0; i < 3; i++) {
+        for(int j = 0; j < 3; j++) {
+            m = fmax(m, fabs(mat[i][j]));
+        }
+    }
+    return m;
+}
+
+//largest deviation of the columns of mat from an orthonormal basis
+static double orthonormal_error(hf_mat3f mat) {
+    double err = 0.0;
+    for(int p = 0; p < 3; p++) {
+        for(int q = 0; q < 3; q++) {
+            double dot = 0.0;
+            for(int i = 0; i < 3; i++) {
+                dot += (double)mat[i][p] * mat[i][q];
+            }
+            err = fmax(err, fabs(dot - (p == q ? 1.0 : 0.0)));
+        }
+    }
+    return err;
+}
+
+static void check(const char* what, double value, double tolerance) {
+    printf("%-44s %12.3g (tolerance %g)\n", what, value, tolerance);
+    if(!(value <= tolerance)) {
+        printf("FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+static void check_eigen(void) {
+    double residual = 0.0;
+    double ortho = 0.0;
+    int unsorted = 0;
+    int improper = 0;
+    for(int n = 0; n < ACCURACY_COUNT; n++) {
+        hf_mat3f a, vectors;
+        float values[3];
+        random_symmetric(a);
+        if(n % 5 == 0) {//nearly diagonal
+            a[0][1] = a[1][0] = 1e-30f;
+        }
+        hf_mat3f_eigen_symmetric(a, values, vectors);
+
+        double scale = fmax(max_abs(a), 1e-30);
+        for(int k = 0; k < 3; k++) {
+            for(int i = 0; i < 3; i++) {
+                double r = -(double)values[k] * vectors[i][k];
+                for(int j = 0; j < 3; j++) {
+                    r += (double)a[i][j] * vectors[j][k];
+                }
+                residual = fmax(residual, fabs(r) / scale);
+            }
+        }
+        ortho = fmax(ortho, orthonormal_error(vectors));
+        unsorted += !(values[0] <= values[1] && values[1] <= values[2]);
+        improper += hf_mat3f_determinant(vectors) < 0.f;
+    }
+    check("eigen residual |A v - l v| / |A|", residual, EIGEN_TOLERANCE);
+    check("eigen |V^T V - I|", ortho, ORTHO_TOLERANCE);
+    check("eigen unsorted eigenvalues", unsorted, 0);
+    check("eigen improper eigenvector bases", improper, 0);
+}
+
+//returns the reconstruction error and accumulates the orthogonality error and improper rotations
+static double polar_errors(hf_mat3f mat, double* ortho, int* improper) {
+    hf_mat3f rotation, stretch;
+    hf_mat3f_polar_decompose(mat, rotation, stretch);
+
+    double err = 0.0;
+    for(int i = 0; i < 3; i++) {
+        for(int j = 0; j < 3; j++) {
+            double rs = 0.0;
+            for(int k = 0; k < 3; k++) {
+                rs += (double)rotation[i][k] * stretch[k][j];
+            }
+            err = fmax(err, fabs(rs - mat[i][j]));
+            err = fmax(err, fabs((double)stretch[i][j] - stretch[j][i]));
+        }
+    }
+    *ortho = fmax(*ortho, orthonormal_error(rotation));
+    *improper += hf_mat3f_determinant(rotation) < 0.f;
+    return err / fmax(max_abs(mat), 1.0);
+}
+
+static void check_polar(void) {
+    double err = 0.0;
+    double ortho = 0.0;
+    int improper = 0;
+    for(int n = 0; n < ACCURACY_COUNT; n++) {
+        hf_mat3f m;
+        random_general(m);
+        err = fmax(err, polar_errors(m, &ortho, &improper));
+    }
+    check("polar |R S - M| / |M|, random", err, POLAR_TOLERANCE);
+
+    hf_mat3f degenerate[] = {
+        { { 0.f, 0.f, 0.f }, { 0.f, 0.f, 0.f }, { 0.f, 0.f, 0.f } },//zero
+        { { 1.f, 2.f, 3.f }, { 2.f, 4.f, 6.f }, { 0.f, 0.f, 0.f } },//rank one
+        { { -1.f, 2.f, 3.f }, { 2.f, -4.f, -6.f }, { 0.5f, -1.f, -1.5f } },//rank one
+        { { 1.f, 0.f, 0.f }, { 0.f, 2.f, 0.f }, { 0.f, 0.f, 0.f } },//rank two
+        { { 1.f, 2.f, 3.f }, { 4.f, 5.f, 6.f }, { 7.f, 8.f, 9.f } },//rank two
+        { { -1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, { 0.f, 0.f, 1.f } },//reflection
+    };
+    double degenerate_err = 0.0;
+    for(size_t i = 0; i < sizeof(degenerate) / sizeof(degenerate[0]); i++) {
+        degenerate_err = fmax(degenerate_err, polar_errors(degenerate[i], &ortho, &improper));
+    }
+    check("polar |R S - M| / |M|, zero/rank 1/rank 2", degenerate_err, POLAR_TOLERANCE);
+    check("polar |R^T R - I|", ortho, ORTHO_TOLERANCE);
+    check("polar improper rotations", improper, 0);
+}
+
+static double ns_per_op(clock_t start) {
+    return 1e9 * (double)(clock() - start) / CLOCKS_PER_SEC / TIMING_COUNT;
+}
+
+static void time_kernels(void) {
+    hf_mat3f* mats = malloc(sizeof(hf_mat3f) * TIMING_COUNT);
+    hf_mat3f* out_a = malloc(sizeof(hf_mat3f) * TIMING_COUNT);
+    hf_mat3f* out_b = malloc(sizeof(hf_mat3f) * TIMING_COUNT);
+    float (*values)[3] = malloc(sizeof(float[3]) * TIMING_COUNT);
+    for(int n = 0; n < TIMING_COUNT; n++) {
+        random_symmetric(mats[n]);
+    }
+
+    clock_t start = clock();
+    for(int n = 0; n < TIMING_COUNT; n++) {
+        hf_mat3f_eigen_symmetric(mats[n], values[n], out_a[n]);
+    }
+    printf("%-44s %12.1f ns/op\n", "hf_mat3f_eigen_symmetric", ns_per_op(start));
+
+    start = clock();
+    hf_mat3f_eigen_symmetric_batch(mats, values, out_a, TIMING_COUNT);
+    printf("%-44s %12.1f ns/op\n", "hf_mat3f_eigen_symmetric_batch", ns_per_op(start));
+
+    for(int n = 0; n < TIMING_COUNT; n++) {
+        random_general(mats[n]);
+    }
+
+    start = clock();
+    for(int n = 0; n < TIMING_COUNT; n++) {
+        hf_mat3f_polar_decompose(mats[n], out_a[n], out_b[n]);
+    }
+    printf("%-44s %12.1f ns/op\n", "hf_mat3f_polar_decompose", ns_per_op(start));
+
+    start = clock();
+    hf_mat3f_polar_decompose_batch(mats, out_a, out_b, TIMING_COUNT);
+    printf("%-44s %12.1f ns/op\n", "hf_mat3f_polar_decompose_batch", ns_per_op(start));
+
+    free(mats);
+    free(out_a);
+    free(out_b);
+    free(values);
+}
+
+int main(void) {
+    check_eigen();
+    check_polar();
+    time_kernels();
+
+    return failures > 0 ? 1 : 0;
+}
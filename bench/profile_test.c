@@ -0,0 +1,277 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <pthread.h>
+
+#include "hf_mat.h"
+#include "hf_vec.h"
+#include "hf_profile.h"
+
+#define THREAD_COUNT 4
+#define ITERATIONS 1000
+#define BATCH_COUNT 8
+#define MAX_ROWS hf_profile_id_count
+
+#if defined(HF_PROFILE_CYCLES) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define COUNTS_CYCLES 1
+#else
+#define COUNTS_CYCLES 0
+#endif
+
+static int failures = 0;
+
+typedef struct row_s {
+    char name[64];
+    unsigned long long calls;
+    unsigned long long elements;
+    unsigned long long cycles;
+} row;
+
+typedef struct report_s {
+    row rows[MAX_ROWS];
+    int count;
+} report;
+
+static void* worker(void* arg) {
+    hf_mat4f locals[BATCH_COUNT], worlds[BATCH_COUNT];
+    for(int i = 0; i < BATCH_COUNT; i++) {
+        hf_mat4f_identity(locals[i]);
+    }
+    hf_vec3f a = { 1.f, 2.f, 3.f }, b = { 4.f, 5.f, 6.f }, out;
+    for(int n = 0; n < ITERATIONS; n++) {
+        hf_vec3f_add(a, b, out);
+        hf_mat4f_multiply_mat4f_affine_batch(locals, NULL, locals, worlds, BATCH_COUNT);
+    }
+    *(hf_profile_block**)arg = hf_profile_local;
+    return NULL;
+}
+
+static const char* skip_space(const char* p) {
+    while(isspace((unsigned char)*p)) {
+        p++;
+    }
+    return p;
+}
+
+//minimal json reader, validates the whole document and keeps the fields of every object in the top level array
+static const char* parse_value(const char* p, report* r, int depth);
+
+static const char* parse_string(const char* p, char* out, size_t size) {
+    size_t len = 0;
+    if(*p++ != '"') {
+        return NULL;
+    }
+    while(*p != '"') {
+        if(*p == '\0' || (unsigned char)*p < 0x20) {
+            return NULL;
+        }
+        if(*p == '\\') {
+            p++;
+            if(strchr("\"\\/bfnrtu", *p) == NULL) {
+                return NULL;
+            }
+        }
+        if(out != NULL && len + 1 < size) {
+            out[len++] = *p;
+        }
+        p++;
+    }
+    if(out != NULL) {
+        out[len] = '\0';
+    }
+    return p + 1;
+}
+
+static const char* parse_number(const char* p, unsigned long long* out) {
+    char* end;
+    strtod(p, &end);
+    if(end == p) {
+        return NULL;
+    }
+    if(out != NULL) {
+        *out = strtoull(p, NULL, 10);
+    }
+    return end;
+}
+
+static const char* parse_object(const char* p, report* r, int depth) {
+    row item;
+    memset(&item, 0, sizeof(item));
+    p = skip_space(p + 1);
+    if(*p == '}') {
+        return p + 1;
+    }
+    for(;;) {
+        char key[64];
+        p = parse_string(skip_space(p), key, sizeof(key));
+        if(p == NULL || *(p = skip_space(p)) != ':') {
+            return NULL;
+        }
+        p = skip_space(p + 1);
+        if(depth == 1 && strcmp(key, "name") == 0) {
+            p = parse_string(p, item.name, sizeof(item.name));
+        }
+        else if(depth == 1 && (strcmp(key, "calls") == 0 || strcmp(key, "elements") == 0 || strcmp(key, "cycles") == 0)) {
+            p = parse_number(p, key[1] == 'a' ? &item.calls : key[1] == 'l' ? &item.elements : &item.cycles);
+        }
+        else {
+            p = parse_value(p, NULL, depth + 1);
+        }
+        if(p == NULL) {
+            return NULL;
+        }
+        p = skip_space(p);
+        if(*p == '}') {
+            break;
+        }
+        if(*p++ != ',') {
+            return NULL;
+        }
+    }
+    if(r != NULL && depth == 1 && r->count < MAX_ROWS) {
+        r->rows[r->count++] = item;
+    }
+    return p + 1;
+}
+
+static const char* parse_array(const char* p, report* r, int depth) {
+    p = skip_space(p + 1);
+    if(*p == ']') {
+        return p + 1;
+    }
+    for(;;) {
+        p = parse_value(skip_space(p), r, depth + 1);
+        if(p == NULL) {
+            return NULL;
+        }
+        p = skip_space(p);
+        if(*p == ']') {
+            return p + 1;
+        }
+        if(*p++ != ',') {
+            return NULL;
+        }
+    }
+}
+
+static const char* parse_value(const char* p, report* r, int depth) {
+    p = skip_space(p);
+    switch(*p) {
+        case '{': return parse_object(p, r, depth);
+        case '[': return parse_array(p, r, depth);
+        case '"': return parse_string(p, NULL, 0);
+        case 't': return strncmp(p, "true", 4) == 0 ? p + 4 : NULL;
+        case 'f': return strncmp(p, "false", 5) == 0 ? p + 5 : NULL;
+        case 'n': return strncmp(p, "null", 4) == 0 ? p + 4 : NULL;
+        default: return parse_number(p, NULL);
+    }
+}
+
+//reads what a dump wrote to a temporary file
+static char* read_dump(void (*dump)(FILE*)) {
+    FILE* f = tmpfile();
+    dump(f);
+    long size = ftell(f);
+    rewind(f);
+    char* text = calloc((size_t)size + 1, 1);
+    if(fread(text, 1, (size_t)size, f) != (size_t)size) {
+        text[0] = '\0';
+    }
+    fclose(f);
+    return text;
+}
+
+static void expect(const char* what, unsigned long long value, unsigned long long expected) {
+    printf("%-52s %12llu (expected %llu)\n", what, value, expected);
+    if(value != expected) {
+        printf("FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+static row* find_row(report* r, const char* name) {
+    for(int i = 0; i < r->count; i++) {
+        if(strcmp(r->rows[i].name, name) == 0) {
+            return &r->rows[i];
+        }
+    }
+    return NULL;
+}
+
+static void check_row(report* r, const char* name, unsigned long long calls, unsigned long long elements) {
+    row empty;
+    memset(&empty, 0, sizeof(empty));
+    row* found = find_row(r, name);
+    if(found == NULL) {
+        found = &empty;
+    }
+    char what[128];
+    sprintf(what, "%s calls", name);
+    expect(what, found->calls, calls);
+    sprintf(what, "%s elements", name);
+    expect(what, found->elements, elements);
+    sprintf(what, "%s counted cycles", name);
+    expect(what, found->cycles > 0, COUNTS_CYCLES);
+}
+
+//the text dump has one "name calls elements cycles" line per called function after its title line
+static void check_text(const char* text, const char* name, unsigned long long calls) {
+    const char* line = strstr(text, name);
+    unsigned long long found = 0;
+    while(line != NULL && !(line[strlen(name)] == ' ' && (line == text || line[-1] == '\n'))) {
+        line = strstr(line + 1, name);
+    }
+    if(line != NULL) {
+        sscanf(line + strlen(name), "%llu", &found);
+    }
+    char what[128];
+    sprintf(what, "%s calls, text dump", name);
+    expect(what, found, calls);
+}
+
+int main(void) {
+    pthread_t threads[THREAD_COUNT];
+    hf_profile_block* thread_blocks[THREAD_COUNT];
+    for(int i = 0; i < THREAD_COUNT; i++) {
+        pthread_create(&threads[i], NULL, worker, &thread_blocks[i]);
+    }
+    for(int i = 0; i < THREAD_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    int shared = 0;
+    for(int i = 0; i < THREAD_COUNT; i++) {
+        for(int j = i + 1; j < THREAD_COUNT; j++) {
+            shared += thread_blocks[i] == thread_blocks[j];
+        }
+    }
+    expect("threads sharing a counter block", (unsigned long long)shared, 0);
+
+    unsigned long long calls = THREAD_COUNT * ITERATIONS;
+    char* json = read_dump(hf_profile_dump_json);
+    report r;
+    r.count = 0;
+    const char* end = parse_value(json, &r, 0);
+    expect("json dump parses", end != NULL && *skip_space(end) == '\0', 1);
+    check_row(&r, "hf_vec3f_add", calls, calls);
+    check_row(&r, "hf_mat4f_identity", THREAD_COUNT * BATCH_COUNT, THREAD_COUNT * BATCH_COUNT);
+    check_row(&r, "hf_mat4f_multiply_mat4f_affine_batch", calls, calls * BATCH_COUNT);
+    expect("json dump functions", (unsigned long long)r.count, 3);
+    free(json);
+
+    char* text = read_dump(hf_profile_dump);
+    check_text(text, "hf_vec3f_add", calls);
+    check_text(text, "hf_mat4f_multiply_mat4f_affine_batch", calls);
+    free(text);
+
+    hf_profile_reset();
+    json = read_dump(hf_profile_dump_json);
+    r.count = 0;
+    end = parse_value(json, &r, 0);
+    expect("json dump parses after reset", end != NULL && *skip_space(end) == '\0', 1);
+    expect("json dump functions after reset", (unsigned long long)r.count, 0);
+    free(json);
+
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "hf_skin.h"
+
+#define VERTEX_COUNT 1000000
+#define BONE_COUNT 64
+#define TOLERANCE 1e-4f
+
+static float random_float(void) {
+    return 2.f * (float)rand() / (float)RAND_MAX - 1.f;
+}
+
+static double elapsed_ms(clock_t start) {
+    return 1000.0 * (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+//the hand written path the kernel replaces: blended palette matrix, then a 4x1 column transform
+static void skin_by_hand(hf_mat4f* palette, hf_vec4i indices, hf_vec4f weights, hf_vec3f position, hf_vec3f normal, hf_vec3f out_position, hf_vec3f out_normal) {
+    hf_mat4f blended, weighted;
+    hf_mat4f_multiply(palette[indices[0]], weights[0], blended);
+    for(int i = 1; i < 4; i++) {
+        hf_mat4f_multiply(palette[indices[i]], weights[i], weighted);
+        hf_mat4f_add(blended, weighted, blended);
+    }
+    hf_mat4x1f p = { { position[0] }, { position[1] }, { position[2] }, { 1.f } };
+    hf_mat4x1f n = { { normal[0] }, { normal[1] }, { normal[2] }, { 0.f } };
+    hf_mat4x1f res_p, res_n;
+    hf_mat4f_multiply_mat4x1f(blended, p, res_p);
+    hf_mat4f_multiply_mat4x1f(blended, n, res_n);
+    for(int i = 0; i < 3; i++) {
+        out_position[i] = res_p[i][0];
+        out_normal[i] = res_n[i][0];
+    }
+}
+
+static float max_difference(hf_vec3f* a, hf_vec3f* b, size_t count) {
+    float diff = 0.f;
+    for(size_t i = 0; i < count; i++) {
+        for(int j = 0; j < 3; j++) {
+            float d = fabsf(a[i][j] - b[i][j]);
+            diff = d > diff ? d : diff;
+        }
+    }
+    return diff;
+}
+
+int main(void) {
+    hf_mat4f palette[BONE_COUNT];
+    for(int b = 0; b < BONE_COUNT; b++) {
+        for(int i = 0; i < 4; i++) {
+            for(int j = 0; j < 4; j++) {
+                palette[b][i][j] = i == 3 ? (j == 3 ? 1.f : 0.f) : random_float();
+            }
+        }
+    }
+
+    hf_vec4i* indices = malloc(sizeof(hf_vec4i) * VERTEX_COUNT);
+    hf_vec4f* weights = malloc(sizeof(hf_vec4f) * VERTEX_COUNT);
+    hf_vec3f* positions = malloc(sizeof(hf_vec3f) * VERTEX_COUNT);
+    hf_vec3f* normals = malloc(sizeof(hf_vec3f) * VERTEX_COUNT);
+    hf_vec3f* out[3][2];
+    for(int i = 0; i < 3; i++) {
+        out[i][0] = malloc(sizeof(hf_vec3f) * VERTEX_COUNT);
+        out[i][1] = malloc(sizeof(hf_vec3f) * VERTEX_COUNT);
+    }
+
+    for(size_t v = 0; v < VERTEX_COUNT; v++) {
+        float total = 0.f;
+        for(int i = 0; i < 4; i++) {
+            indices[v][i] = rand() % BONE_COUNT;
+            weights[v][i] = (float)rand() / (float)RAND_MAX;
+            total += weights[v][i];
+        }
+        for(int i = 0; i < 4; i++) {
+            weights[v][i] /= total;
+        }
+        for(int i = 0; i < 3; i++) {
+            positions[v][i] = random_float();
+            normals[v][i] = random_float();
+        }
+    }
+
+    clock_t start = clock();
+    for(size_t v = 0; v < VERTEX_COUNT; v++) {
+        skin_by_hand(palette, indices[v], weights[v], positions[v], normals[v], out[0][0][v], out[0][1][v]);
+    }
+    double hand_ms = elapsed_ms(start);
+
+    start = clock();
+    for(size_t v = 0; v < VERTEX_COUNT; v++) {
+        hf_skin_vertex(palette, indices[v], weights[v], positions[v], normals[v], out[1][0][v], out[1][1][v]);
+    }
+    double vertex_ms = elapsed_ms(start);
+
+    start = clock();
+    hf_skin_batch(palette, indices, weights, positions, normals, out[2][0], out[2][1], VERTEX_COUNT);
+    double batch_ms = elapsed_ms(start);
+
+    printf("%d vertices, %d bones\n", VERTEX_COUNT, BONE_COUNT);
+    printf("%-32s %10.2f ms\n", "hand written", hand_ms);
+    printf("%-32s %10.2f ms\n", "hf_skin_vertex", vertex_ms);
+    printf("%-32s %10.2f ms\n", "hf_skin_batch", batch_ms);
+
+    float diff = 0.f;
+    for(int i = 1; i < 3; i++) {
+        for(int j = 0; j < 2; j++) {
+            float d = max_difference(out[0][j], out[i][j], VERTEX_COUNT);
+            diff = d > diff ? d : diff;
+        }
+    }
+    printf("max difference to the hand written path: %g\n", diff);
+
+    for(int i = 0; i < 3; i++) {
+        free(out[i][0]);
+        free(out[i][1]);
+    }
+    free(indices);
+    free(weights);
+    free(positions);
+    free(normals);
+
+    if(diff > TOLERANCE) {
+        printf("FAILED: difference above %g\n", TOLERANCE);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "shared.h"
+
+#define MAX_COSTED_FUNCTIONS 1024
+
+typedef struct CostEntry_s {
+    char name[64];//without the hf_ prefix
+    FuncCost self;
+    FuncCost total;
+    bool resolved;
+} CostEntry;
+
+static CostEntry entries[MAX_COSTED_FUNCTIONS];
+static size_t entry_count = 0;
+
+static CostEntry* find_entry(const char* name) {
+    for(size_t i = 0; i < entry_count; i++) {
+        if(strcmp(entries[i].name, name) == 0) {
+            return &entries[i];
+        }
+    }
+    return NULL;
+}
+
+void cost_add_call(FuncCost* cost, int count, const char* format, ...) {
+    char name[64];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(name, sizeof(name), format, args);
+    va_end(args);
+
+    if(cost->call_count >= MAX_COST_CALLS) {
+        fprintf(stderr, "cost: call to hf_%s exceeds MAX_COST_CALLS (%d)\n", name, MAX_COST_CALLS);
+        exit(1);
+    }
+
+    FuncCall* call = &cost->calls[cost->call_count++];
+    strcpy(call->name, name);
+    call->count = count;
+}
+
+void register_cost(FuncCost cost, const char* format, ...) {
+    char name[64];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(name, sizeof(name), format, args);
+    va_end(args);
+
+    if(entry_count >= MAX_COSTED_FUNCTIONS) {
+        fprintf(stderr, "cost: more than %d functions, raise MAX_COSTED_FUNCTIONS\n", MAX_COSTED_FUNCTIONS);
+        exit(1);
+    }
+    if(find_entry(name) != NULL) {
+        fprintf(stderr, "cost: hf_%s registered twice\n", name);
+        exit(1);
+    }
+
+    CostEntry* entry = &entries[entry_count++];
+    strcpy(entry->name, name);
+    entry->self = cost;
+    entry->resolved = false;
+}
+
+//accumulates the cost of every nested call into total, callees may be registered after their callers
+static FuncCost resolve_total(CostEntry* entry) {
+    if(entry->resolved) {
+        return entry->total;
+    }
+
+    FuncCost total = entry->self;
+    for(int i = 0; i < entry->self.call_count; i++) {
+        CostEntry* callee = find_entry(entry->self.calls[i].name);
+        if(callee == NULL) {
+            fprintf(stderr, "cost: hf_%s calls hf_%s, which has no registered cost\n", entry->name, entry->self.calls[i].name);
+            exit(1);
+        }
+        FuncCost c = resolve_total(callee);
+        int n = entry->self.calls[i].count;
+        total.muls += c.muls * n;
+        total.adds += c.adds * n;
+        total.divs += c.divs * n;
+        total.sqrts += c.sqrts * n;
+        total.load_bytes += c.load_bytes * n;
+        total.store_bytes += c.store_bytes * n;
+    }
+
+    entry->total = total;
+    entry->resolved = true;
+    return total;
+}
+
+static int direct_calls(FuncCost cost) {
+    int calls = 0;
+    for(int i = 0; i < cost.call_count; i++) {
+        calls += cost.calls[i].count;
+    }
+    return calls;
+}
+
+static void print_json_cost(FILE* f, const char* key, FuncCost c) {
+    fprintf(f,
+        "\t\t\"%s\": { \"muls\": %d, \"adds\": %d, \"divs\": %d, \"sqrts\": %d, \"load_bytes\": %d, \"store_bytes\": %d }",
+        key, c.muls, c.adds, c.divs, c.sqrts, c.load_bytes, c.store_bytes
+    );
+}
+
+static void print_json(FILE* f) {
+    fprintf(f, "[");
+    for(size_t i = 0; i < entry_count; i++) {
+        CostEntry* e = &entries[i];
+        fprintf(f,
+            "%s\n"
+            "\t{\n"
+            "\t\t\"name\": \"hf_%s\",\n"
+            "\t\t\"batched\": %s,\n",
+            i == 0 ? "" : ",", e->name, e->self.batched ? "true" : "false"
+        );
+        print_json_cost(f, "self", e->self);
+        fprintf(f, ",\n");
+        print_json_cost(f, "total", resolve_total(e));
+        fprintf(f, ",\n\t\t\"calls\": {");
+        for(int j = 0; j < e->self.call_count; j++) {
+            fprintf(f, "%s \"hf_%s\": %d", j == 0 ? "" : ",", e->self.calls[j].name, e->self.calls[j].count);
+        }
+        fprintf(f, e->self.call_count > 0 ? " }\n\t}" : "}\n\t}");
+    }
+    fprintf(f, "\n]\n");
+}
+
+static void print_defines(FILE* f) {
+    for(size_t i = 0; i < entry_count; i++) {
+        CostEntry* e = &entries[i];
+        char upper[64];
+        size_t len = strlen(e->name);
+        for(size_t j = 0; j <= len; j++) {
+            upper[j] = (char)toupper((unsigned char)e->name[j]);
+        }
+
+        FuncCost t = resolve_total(e);
+        fprintf(f,
+            "\n"
+            "#define HF_COST_%s_MULS %d\n"
+            "#define HF_COST_%s_ADDS %d\n"
+            "#define HF_COST_%s_DIVS %d\n"
+            "#define HF_COST_%s_SQRTS %d\n"
+            "#define HF_COST_%s_LOAD_BYTES %d\n"
+            "#define HF_COST_%s_STORE_BYTES %d\n"
+            "#define HF_COST_%s_CALLS %d\n",
+            upper, t.muls,
+            upper, t.adds,
+            upper, t.divs,
+            upper, t.sqrts,
+            upper, t.load_bytes,
+            upper, t.store_bytes,
+            upper, direct_calls(e->self)
+        );
+    }
+}
+
+void create_cost(void) {
+    FILE* header = fopen("./hf_cost.h", "w");
+    fprintf(header,
+        "#ifndef HF_COST_H\n"
+        "#define HF_COST_H\n"
+        "\n"
+        "//static cost of each generated function, including the functions it calls (CALLS only counts direct calls)\n"
+        "//memory traffic is the bytes read from arguments and written to outputs. batched functions are costed per element\n"
+    );
+    print_defines(header);
+    fprintf(header,
+        "\n#endif//HF_COST_H\n"
+    );
+    fclose(header);
+
+    FILE* json = fopen("./hf_cost.json", "w");
+    print_json(json);
+    fclose(json);
+}
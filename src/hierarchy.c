@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stddef.h>
+
+#include "shared.h"
+
+static void print_struct(FileData f) {
+    fprintf(f.header,
+        "//transform hierarchy stored in depth-first preorder, so parents[i] < i and the subtree of node i\n"
+        "//is the contiguous range [i, i + subtree_sizes[i]). all arrays hold count entries and are owned by the caller\n"
+        "typedef struct hf_hierarchy_s {\n"
+        "\tint* parents;//-1 for root nodes\n"
+        "\tint* subtree_sizes;//filled by hf_hierarchy_build\n"
+        "\tunsigned char* dirty;//nodes whose local transform changed since the last update\n"
+        "\tint* dirty_roots;//scratch space for hf_hierarchy_update\n"
+        "\thf_mat4f* locals;//affine, last row 0 0 0 1\n"
+        "\thf_mat4f* worlds;\n"
+        "\tsize_t count;\n"
+        "} hf_hierarchy;\n"
+        "\n"
+    );
+}
+
+static void print_build(FileData f) {
+    //header
+    fprintf(f.header, "void hf_hierarchy_build(hf_hierarchy* h);\n");
+
+    //source, children always follow their parents so a reverse pass accumulates every subtree size
+    fprintf(f.source,
+        "\n"
+        "void hf_hierarchy_build(hf_hierarchy* h) {\n"
+    );
+    print_profile_hook(f, "h->count", "hierarchy_build");
+    fprintf(f.source,
+        "\tfor(size_t i = 0; i < h->count; i++) {\n"
+        "\t\th->subtree_sizes[i] = 1;\n"
+        "\t\th->dirty[i] = 1;\n"
+        "\t}\n"
+        "\tfor(size_t i = h->count; i-- > 0;) {\n"
+        "\t\tif(h->parents[i] >= 0) {\n"
+        "\t\t\th->subtree_sizes[h->parents[i]] += h->subtree_sizes[i];\n"
+        "\t\t}\n"
+        "\t}\n"
+        "}\n"
+    );
+
+    //cost
+    register_cost((FuncCost) { .adds = 1, .load_bytes = (int)sizeof(int) * 2, .store_bytes = (int)sizeof(int) + 1, .batched = true }, "hierarchy_build");
+}
+
+static void print_set_local(FileData f) {
+    //header
+    fprintf(f.header, "void hf_hierarchy_set_local(hf_hierarchy* h, int node, hf_mat4f local);\n");
+
+    //source
+    fprintf(f.source,
+        "\n"
+        "void hf_hierarchy_set_local(hf_hierarchy* h, int node, hf_mat4f local) {\n"
+    );
+    print_profile_hook(f, "1", "hierarchy_set_local");
+    fprintf(f.source,
+        "\tmemcpy(h->locals[node], local, sizeof(h->locals[0]));\n"
+        "\th->dirty[node] = 1;\n"
+        "}\n"
+    );
+
+    //cost
+    register_cost((FuncCost) { .load_bytes = (int)sizeof(float) * 16, .store_bytes = (int)sizeof(float) * 16 + 1 }, "hierarchy_set_local");
+}
+
+static void print_update(FileData f) {
+    //header
+    fprintf(f.header, "size_t hf_hierarchy_update(hf_hierarchy* h);\n");
+
+    //source, recomputes the subtree of every dirty node and returns how many nodes were recomputed
+    fprintf(f.source,
+        "\n"
+        "size_t hf_hierarchy_update(hf_hierarchy* h) {\n"
+    );
+    print_profile_hook(f, "h->count", "hierarchy_update");
+    fprintf(f.source,
+        "\tint root_count = 0;\n"
+        "\tsize_t recomputed = 0;\n"
+        "\tfor(size_t i = 0; i < h->count;) {\n"
+        "\t\tif(h->dirty[i]) {//the whole subtree is recomputed, so its descendants need no check\n"
+        "\t\t\th->dirty_roots[root_count++] = (int)i;\n"
+        "\t\t\trecomputed += (size_t)h->subtree_sizes[i];\n"
+        "\t\t\ti += (size_t)h->subtree_sizes[i];\n"
+        "\t\t}\n"
+        "\t\telse {\n"
+        "\t\t\ti++;\n"
+        "\t\t}\n"
+        "\t}\n"
+        "\n"
+        "\t//dirty subtrees are disjoint and their parents are clean, so they are independent\n"
+        "#if defined(_OPENMP)\n"
+        "#pragma omp parallel for schedule(dynamic, 16) if(root_count > 64)\n"
+        "#endif\n"
+        "\tfor(int r = 0; r < root_count; r++) {\n"
+        "\t\tint start = h->dirty_roots[r];\n"
+        "\t\tint size = h->subtree_sizes[start];\n"
+        "\t\tint parent = h->parents[start];\n"
+        "\t\tif(parent < 0) {\n"
+        "\t\t\tmemcpy(h->worlds[start], h->locals[start], sizeof(h->worlds[0]));\n"
+        "\t\t}\n"
+        "\t\telse {\n"
+        "\t\t\thf_mat4f_multiply_mat4f_affine(h->worlds[parent], h->locals[start], h->worlds[start]);\n"
+        "\t\t}\n"
+        "\t\thf_mat4f_multiply_mat4f_affine_batch(h->worlds, h->parents + start + 1, h->locals + start + 1, h->worlds + start + 1, (size_t)(size - 1));\n"
+        "\t\tmemset(h->dirty + start, 0, (size_t)size);\n"
+        "\t}\n"
+        "\treturn recomputed;\n"
+        "}\n"
+    );
+
+    //cost, per node of the hierarchy, for the worst case where every node is a dirty root: the scan reads its
+    //dirty flag and subtree size and advances two counters, the root index is stored and read back along with
+    //its subtree size and parent, the flag is cleared and the world transform takes one single affine product
+    //(a copy for nodes without a parent), while the batch kernel is called with an empty range
+    FuncCost cost = {
+        .adds = 2,
+        .load_bytes = 1 + (int)sizeof(int) * 4,
+        .store_bytes = (int)sizeof(int) + 1,
+        .batched = true,
+    };
+    cost_add_call(&cost, 1, "mat4f_multiply_mat4f_affine");
+    register_cost(cost, "hierarchy_update");
+}
+
+void create_hierarchy(bool profile) {
+    FILE* header = fopen("./hf_hierarchy.h", "w");
+    fprintf(header,
+        "#ifndef HF_HIERARCHY_H\n"
+        "#define HF_HIERARCHY_H\n"
+        "\n"
+        "#include <stddef.h>\n"
+        "\n"
+        "#include \"hf_mat.h\"\n"
+        "\n"
+    );
+
+    FILE* source = fopen("./hf_hierarchy.c", "w");
+    fprintf(source,
+        "#include \"../include/hf_hierarchy.h\"\n\n"
+        "#include <string.h>\n"
+    );
+    if(profile) {
+        fprintf(source, "\n#include \"../include/hf_profile.h\"\n");
+    }
+
+    FileData file_data = { header, source, profile };
+
+    print_struct(file_data);
+    print_build(file_data);
+    print_set_local(file_data);
+    print_update(file_data);
+
+    fprintf(header,
+        "\n#endif//HF_HIERARCHY_H\n"
+    );
+
+    fclose(header);
+    fclose(source);
+}
@@ -1,15 +1,31 @@
 #include <stdio.h>
 #include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
 
-void create_mat(void);
-void create_vec(void);
+void create_mat(bool profile);
+void create_vec(bool profile);
+void create_skin(bool profile);
+void create_hierarchy(bool profile);
+void create_profile(void);
+void create_cost(void);
 
 int main(int argc, char* argv[]) {
-    (void)argc;
-    (void)argv;
+    bool profile = false;
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--profile") == 0) {//wrap every generated function with an HF_PROFILE hook
+            profile = true;
+        }
+    }
 
-    create_mat();
-    create_vec();
+    create_mat(profile);
+    create_vec(profile);
+    create_skin(profile);
+    create_hierarchy(profile);
+    if(profile) {//must run last, as it emits the ids of every hooked function
+        create_profile();
+    }
+    create_cost();
 
     return 0;
 }
@@ -70,8 +70,13 @@ static void print_copy(FileData f, MatData m) {
 
     //copy source
     fprintf(f.source, "\nvoid hf_%s_copy(%s mat, %s out) {\n", m.prefix, m.name, m.name);
+    print_profile_hook(f, "1", "%s_copy", m.prefix);
     fprintf(f.source, "\tmemcpy(out, mat, sizeof(out[0][0]) * %d);\n", m.dim.rows * m.dim.cols);
     fprintf(f.source, "}\n");
+
+    //copy cost
+    int bytes = (int)sizeof(float) * m.dim.rows * m.dim.cols;
+    register_cost((FuncCost) { .load_bytes = bytes, .store_bytes = bytes }, "%s_copy", m.prefix);
 }
 
 static void print_identity(FileData f_data, MatData m_data) {
@@ -88,10 +93,11 @@ static void print_identity(FileData f_data, MatData m_data) {
     //identity source
     fprintf(f_data.source,
         "\n"
-        "void hf_%s_identity(%s out) {\n"
-        "\tfloat values[] = {\n",
+        "void hf_%s_identity(%s out) {\n",
         m_data.prefix, m_data.name
     );
+    print_profile_hook(f_data, "1", "%s_identity", m_data.prefix);
+    fprintf(f_data.source, "\tfloat values[] = {\n");
 
     for(int row = 0; row < m_data.dim.cols; row++) {
         fprintf(f_data.source, "\t\t");
@@ -110,6 +116,9 @@ static void print_identity(FileData f_data, MatData m_data) {
         "}\n",
         m_data.dim.rows * m_data.dim.cols
     );
+
+    //identity cost
+    register_cost((FuncCost) { .store_bytes = (int)sizeof(float) * m_data.dim.rows * m_data.dim.cols }, "%s_identity", m_data.prefix);
 }
 
 static void print_transpose(FileData f_data, MatData m_data) {
@@ -127,10 +136,11 @@ static void print_transpose(FileData f_data, MatData m_data) {
     //transpose source
     fprintf(f_data.source,
         "\n"
-        "void hf_%s_transpose(%s mat, %s out) {\n"
-        "\t%s tmp;\n",
-        m_data.prefix, m_data.name, other_data.name, other_data.name
+        "void hf_%s_transpose(%s mat, %s out) {\n",
+        m_data.prefix, m_data.name, other_data.name
     );
+    print_profile_hook(f_data, "1", "%s_transpose", m_data.prefix);
+    fprintf(f_data.source, "\t%s tmp;\n", other_data.name);
 
     fprintf(f_data.source,
         "\tfor(int i = 0; i < %d; i++) {\n"
@@ -143,6 +153,10 @@ static void print_transpose(FileData f_data, MatData m_data) {
     );
 
     fprintf(f_data.source, "}\n");
+
+    //transpose cost
+    int bytes = (int)sizeof(float) * m_data.dim.rows * m_data.dim.cols;
+    register_cost((FuncCost) { .load_bytes = bytes, .store_bytes = bytes }, "%s_transpose", m_data.prefix);
 }
 
 static void print_determinant(FileData f_data, MatData m_data) {
@@ -162,6 +176,7 @@ static void print_determinant(FileData f_data, MatData m_data) {
         "float hf_%s_determinant(%s mat) {\n",
         m_data.prefix, m_data.name
     );
+    print_profile_hook(f_data, "1", "%s_determinant", m_data.prefix);
 
     if(m_data.dim.rows == 2) {//hand made logic
         fprintf(f_data.source,
@@ -196,6 +211,15 @@ static void print_determinant(FileData f_data, MatData m_data) {
         fprintf(f_data.source, "\n\t;\n");
     }
     fprintf(f_data.source, "}\n");
+
+    //determinant cost, expansion along the first column
+    int n = m_data.dim.rows;
+    FuncCost cost = { .muls = n, .adds = n - 1, .load_bytes = (int)sizeof(float) * n * n };
+    if(n > 2) {
+        MatData n_minus_one = mat_data_create((MatDims) { .rows = n - 1, .cols = n - 1 });
+        cost_add_call(&cost, n, "%s_determinant", n_minus_one.prefix);
+    }
+    register_cost(cost, "%s_determinant", m_data.prefix);
 }
 
 static void print_minor(FileData f_data, MatData m_data) {
@@ -214,6 +238,7 @@ static void print_minor(FileData f_data, MatData m_data) {
         "float hf_%s_minor(%s mat, int i, int j) {\n",
         m_data.prefix, m_data.name
     );
+    print_profile_hook(f_data, "1", "%s_minor", m_data.prefix);
 
     if(m_data.dim.rows == 2) {
         fprintf(f_data.source, "\treturn mat[1 - i][1 - j];\n");
@@ -242,6 +267,15 @@ static void print_minor(FileData f_data, MatData m_data) {
     }
 
     fprintf(f_data.source, "}\n");
+
+    //minor cost
+    int n = m_data.dim.rows;
+    FuncCost cost = { .load_bytes = (int)sizeof(float) * (n - 1) * (n - 1) };
+    if(n > 2) {
+        MatData n_minus_one = mat_data_create((MatDims) { .rows = n - 1, .cols = n - 1 });
+        cost_add_call(&cost, 1, "%s_determinant", n_minus_one.prefix);
+    }
+    register_cost(cost, "%s_minor", m_data.prefix);
 }
 
 static void print_inverse(FileData f_data, MatData m_data) {
@@ -260,6 +294,7 @@ static void print_inverse(FileData f_data, MatData m_data) {
         "void hf_%s_inverse(%s mat, %s out) {\n",
         m_data.prefix, m_data.name, m_data.name
     );
+    print_profile_hook(f_data, "1", "%s_inverse", m_data.prefix);
 
     fprintf(f_data.source,
         "\tfloat det = hf_%s_determinant(mat);\n"
@@ -283,6 +318,14 @@ static void print_inverse(FileData f_data, MatData m_data) {
     );
 
     fprintf(f_data.source, "}\n");
+
+    //inverse cost, adjugate scaled by the reciprocal of the determinant
+    int n = m_data.dim.rows;
+    FuncCost cost = { .muls = n * n, .divs = 1, .store_bytes = (int)sizeof(float) * n * n };
+    cost_add_call(&cost, 1, "%s_determinant", m_data.prefix);
+    cost_add_call(&cost, n * n, "%s_minor", m_data.prefix);
+    cost_add_call(&cost, 1, "%s_multiply", m_data.prefix);
+    register_cost(cost, "%s_inverse", m_data.prefix);
 }
 
 static void print_scalar(FileData f, MatData m) {
@@ -294,17 +337,24 @@ static void print_scalar(FileData f, MatData m) {
 
     //source
     fprintf(f.source,
-        "\nvoid hf_%s_multiply(%s mat, float scalar, %s out) {\n"
+        "\nvoid hf_%s_multiply(%s mat, float scalar, %s out) {\n",
+        m.prefix, m.name, m.name
+    );
+    print_profile_hook(f, "1", "%s_multiply", m.prefix);
+    fprintf(f.source,
         "\tfor(int i = 0; i < %d; i++) {\n"
         "\t\tfor(int j = 0; j < %d; j++) {\n"
         "\t\t\tout[i][j] = mat[i][j] * scalar;\n"
         "\t\t}\n"
         "\t}\n"
         "}\n",
-        m.prefix, m.name, m.name,
         m.dim.rows,
         m.dim.cols
     );
+
+    //cost
+    int elements = m.dim.rows * m.dim.cols;
+    register_cost((FuncCost) { .muls = elements, .load_bytes = (int)sizeof(float) * elements, .store_bytes = (int)sizeof(float) * elements }, "%s_multiply", m.prefix);
 }
 
 static void print_add(FileData f, MatData m) {
@@ -317,7 +367,11 @@ static void print_add(FileData f, MatData m) {
     //source
     fprintf(f.source,
         "\n"
-        "void hf_%s_add(%s a, %s b, %s out) {\n"//0
+        "void hf_%s_add(%s a, %s b, %s out) {\n",
+        m.prefix, m.name, m.name, m.name
+    );
+    print_profile_hook(f, "1", "%s_add", m.prefix);
+    fprintf(f.source,
         "\tfor(int i = 0; i < %d; i++) {\n"//1
         "\t\tfor(int j = 0; j < %d; j++) {\n"//2
         "\t\t\tout[i][j] = a[i][j] + b[i][j];\n"//3
@@ -325,10 +379,13 @@ static void print_add(FileData f, MatData m) {
         "\t}\n"//5
         "}\n"
         ,
-        m.prefix, m.name, m.name, m.name,//0
         m.dim.rows,//2
         m.dim.cols//3
     );
+
+    //cost
+    int elements = m.dim.rows * m.dim.cols;
+    register_cost((FuncCost) { .adds = elements, .load_bytes = (int)sizeof(float) * elements * 2, .store_bytes = (int)sizeof(float) * elements }, "%s_add", m.prefix);
 }
 
 static void print_multiply(FileData f, MatData a, MatData b) {
@@ -346,7 +403,11 @@ static void print_multiply(FileData f, MatData a, MatData b) {
     //source
     fprintf(f.source,
         "\n"
-        "void hf_%s_multiply_%s(%s a, %s b, %s out) {\n"//0
+        "void hf_%s_multiply_%s(%s a, %s b, %s out) {\n",
+        a.prefix, b.prefix, a.name, b.name, data_res.name
+    );
+    print_profile_hook(f, "1", "%s_multiply_%s", a.prefix, b.prefix);
+    fprintf(f.source,
         "\t%s tmp;\n"//1
         "\tfor(int i = 0; i < %d; i++) {\n"//2
         "\t\tfor(int j = 0; j < %d; j++) {\n"//3
@@ -360,13 +421,409 @@ static void print_multiply(FileData f, MatData a, MatData b) {
         "\tmemcpy(out, tmp, sizeof(out[0][0]) * %d);\n"//11
         "}\n"
         ,
-        a.prefix, b.prefix, a.name, b.name, data_res.name,//0
         data_res.name,//1
         data_res.dim.rows,//2
         data_res.dim.cols,//3
         b.dim.rows,//5
         data_res.dim.rows * data_res.dim.cols//11
     );
+
+    //cost
+    int fma = data_res.dim.rows * data_res.dim.cols * b.dim.rows;
+    FuncCost cost = {
+        .muls = fma,
+        .adds = fma,
+        .load_bytes = (int)sizeof(float) * (a.dim.rows * a.dim.cols + b.dim.rows * b.dim.cols),
+        .store_bytes = (int)sizeof(float) * data_res.dim.rows * data_res.dim.cols,
+    };
+    register_cost(cost, "%s_multiply_%s", a.prefix, b.prefix);
+}
+
+#define EIGEN_SWEEPS 5
+
+//emits one cyclic jacobi rotation that zeroes the symmetric element (p, q), with r the remaining index
+static void print_jacobi_rotation(FileData f, int p, int q) {
+    int r = 3 - p - q;
+    int rp_lo = r < p ? r : p, rp_hi = r < p ? p : r;
+    int rq_lo = r < q ? r : q, rq_hi = r < q ? q : r;
+
+    fprintf(f.source,
+        "\t\tif(a%d%d != 0.f) {\n"
+        "\t\t\tfloat theta = (a%d%d - a%d%d) / (2.f * a%d%d);\n"
+        "\t\t\tfloat t = 1.f / (fabsf(theta) + sqrtf(theta * theta + 1.f));\n"//t becomes 0 if theta * theta overflows
+        "\t\t\tt = theta < 0.f ? -t : t;\n"
+        "\t\t\tfloat c = 1.f / sqrtf(t * t + 1.f);\n"
+        "\t\t\tfloat s = t * c;\n"
+        "\t\t\ta%d%d -= t * a%d%d;\n"
+        "\t\t\ta%d%d += t * a%d%d;\n"
+        "\t\t\ta%d%d = 0.f;\n"
+        "\t\t\tfloat a_rp = a%d%d, a_rq = a%d%d;\n"
+        "\t\t\ta%d%d = c * a_rp - s * a_rq;\n"
+        "\t\t\ta%d%d = s * a_rp + c * a_rq;\n"
+        "\t\t\tfor(int k = 0; k < 3; k++) {\n"
+        "\t\t\t\tfloat v_p = v[k][%d], v_q = v[k][%d];\n"
+        "\t\t\t\tv[k][%d] = c * v_p - s * v_q;\n"
+        "\t\t\t\tv[k][%d] = s * v_p + c * v_q;\n"
+        "\t\t\t}\n"
+        "\t\t}\n",
+        p, q,
+        q, q, p, p, p, q,
+        p, p, p, q,
+        q, q, p, q,
+        p, q,
+        rp_lo, rp_hi, rq_lo, rq_hi,
+        rp_lo, rp_hi,
+        rq_lo, rq_hi,
+        p, q,
+        p,
+        q
+    );
+}
+
+static void print_eigen_symmetric(FileData f, MatData m) {
+    if(m.dim.rows != 3 || m.dim.cols != 3) {
+        return;
+    }
+
+    //header
+    fprintf(f.header,
+        "//out_vectors holds the eigenvectors as columns and is a proper rotation, out_values is sorted ascending\n"
+        "void hf_%s_eigen_symmetric(%s mat, float out_values[3], %s out_vectors);\n",
+        m.prefix, m.name, m.name
+    );
+
+    //source, fixed number of cyclic jacobi sweeps over the upper triangle, eigenvalues sorted ascending
+    fprintf(f.source,
+        "\n"
+        "void hf_%s_eigen_symmetric(%s mat, float out_values[3], %s out_vectors) {\n",
+        m.prefix, m.name, m.name
+    );
+    print_profile_hook(f, "1", "%s_eigen_symmetric", m.prefix);
+    fprintf(f.source,
+        "\tfloat a00 = mat[0][0], a11 = mat[1][1], a22 = mat[2][2];\n"
+        "\tfloat a01 = mat[0][1], a02 = mat[0][2], a12 = mat[1][2];\n"
+        "\t%s v = {\n"
+        "\t\t{ 1.f, 0.f, 0.f },\n"
+        "\t\t{ 0.f, 1.f, 0.f },\n"
+        "\t\t{ 0.f, 0.f, 1.f },\n"
+        "\t};\n"
+        "\tfor(int sweep = 0; sweep < %d; sweep++) {\n",
+        m.name, EIGEN_SWEEPS
+    );
+    print_jacobi_rotation(f, 0, 1);
+    print_jacobi_rotation(f, 0, 2);
+    print_jacobi_rotation(f, 1, 2);
+    fprintf(f.source,
+        "\t}\n"
+        "\tfloat d[3] = { a00, a11, a22 };\n"
+    );
+
+    //sorting network, eigenvector columns follow their eigenvalues
+    //one column of each swap is negated so out_vectors stays a rotation like the jacobi rotations it accumulates
+    int swaps[3][2] = { { 0, 1 }, { 1, 2 }, { 0, 1 } };
+    for(int i = 0; i < 3; i++) {
+        int a = swaps[i][0];
+        int b = swaps[i][1];
+        fprintf(f.source,
+            "\tif(d[%d] > d[%d]) {\n"
+            "\t\tfloat tmp = d[%d];\n"
+            "\t\td[%d] = d[%d];\n"
+            "\t\td[%d] = tmp;\n"
+            "\t\tfor(int k = 0; k < 3; k++) {\n"
+            "\t\t\ttmp = v[k][%d];\n"
+            "\t\t\tv[k][%d] = v[k][%d];\n"
+            "\t\t\tv[k][%d] = -tmp;\n"
+            "\t\t}\n"
+            "\t}\n",
+            a, b,
+            a,
+            a, b,
+            b,
+            a,
+            a, b,
+            b
+        );
+    }
+    fprintf(f.source,
+        "\tmemcpy(out_values, d, sizeof(d));\n"
+        "\tmemcpy(out_vectors, v, sizeof(out_vectors[0][0]) * 9);\n"
+        "}\n"
+    );
+
+    //cost, per rotation: 22 multiplies, 14 adds, 3 divides and 2 square roots
+    int rotations = EIGEN_SWEEPS * 3;
+    FuncCost cost = {
+        .muls = rotations * 22,
+        .adds = rotations * 14,
+        .divs = rotations * 3,
+        .sqrts = rotations * 2,
+        .load_bytes = (int)sizeof(float) * 6,
+        .store_bytes = (int)sizeof(float) * 12,
+    };
+    register_cost(cost, "%s_eigen_symmetric", m.prefix);
+}
+
+static void print_polar_decompose(FileData f, MatData m) {
+    if(m.dim.rows != 3 || m.dim.cols != 3) {
+        return;
+    }
+
+    //header
+    fprintf(f.header,
+        "//out_rotation is a proper rotation, when det(mat) < 0 out_stretch is negative along its smallest axis\n"
+        "void hf_%s_polar_decompose(%s mat, %s out_rotation, %s out_stretch);\n",
+        m.prefix, m.name, m.name, m.name
+    );
+
+    //source, mat = rotation * stretch. rotation is built from the eigenvectors of mat^T * mat and the left singular
+    //vectors so it stays a rotation even when mat is singular. stretch is the symmetric part of rotation^T * mat rather
+    //than sqrt(mat^T * mat), whose smallest singular value keeps only half of float precision
+    fprintf(f.source,
+        "\n"
+        "void hf_%s_polar_decompose(%s mat, %s out_rotation, %s out_stretch) {\n",
+        m.prefix, m.name, m.name, m.name
+    );
+    print_profile_hook(f, "1", "%s_polar_decompose", m.prefix);
+    fprintf(f.source,
+        "\t%s mtm, v, u, rotation, rtm, stretch;\n"
+        "\tfor(int i = 0; i < 3; i++) {\n"
+        "\t\tfor(int j = 0; j < 3; j++) {\n"
+        "\t\t\tmtm[i][j] = mat[0][i] * mat[0][j] + mat[1][i] * mat[1][j] + mat[2][i] * mat[2][j];\n"
+        "\t\t}\n"
+        "\t}\n"
+        "\tfloat values[3];\n"
+        "\thf_%s_eigen_symmetric(mtm, values, v);\n"
+        "\tfor(int k = 1; k < 3; k++) {\n"
+        "\t\tfor(int i = 0; i < 3; i++) {\n"
+        "\t\t\tu[k][i] = mat[i][0] * v[0][k] + mat[i][1] * v[1][k] + mat[i][2] * v[2][k];\n"
+        "\t\t}\n"
+        "\t}\n"
+        "\tfloat len = sqrtf(u[2][0] * u[2][0] + u[2][1] * u[2][1] + u[2][2] * u[2][2]);\n"
+        "\tfor(int i = 0; i < 3; i++) {\n"
+        "\t\tu[2][i] = len > 0.f ? u[2][i] / len : v[i][2];\n"
+        "\t}\n"
+        "\tfloat proj = u[1][0] * u[2][0] + u[1][1] * u[2][1] + u[1][2] * u[2][2];\n"
+        "\tfor(int i = 0; i < 3; i++) {\n"
+        "\t\tu[1][i] -= proj * u[2][i];\n"
+        "\t}\n"
+        "\tlen = sqrtf(u[1][0] * u[1][0] + u[1][1] * u[1][1] + u[1][2] * u[1][2]);\n"
+        "\tif(len == 0.f) {//rank one, take any direction perpendicular to u[2]\n"
+        "\t\tint axis = fabsf(u[2][0]) < fabsf(u[2][1]) ? (fabsf(u[2][0]) < fabsf(u[2][2]) ? 0 : 2) : (fabsf(u[2][1]) < fabsf(u[2][2]) ? 1 : 2);\n"
+        "\t\tfloat e[3] = { 0.f, 0.f, 0.f };\n"
+        "\t\te[axis] = 1.f;\n"
+        "\t\tu[1][0] = u[2][1] * e[2] - u[2][2] * e[1];\n"
+        "\t\tu[1][1] = u[2][2] * e[0] - u[2][0] * e[2];\n"
+        "\t\tu[1][2] = u[2][0] * e[1] - u[2][1] * e[0];\n"
+        "\t\tlen = sqrtf(u[1][0] * u[1][0] + u[1][1] * u[1][1] + u[1][2] * u[1][2]);\n"
+        "\t}\n"
+        "\tfor(int i = 0; i < 3; i++) {\n"
+        "\t\tu[1][i] /= len;\n"
+        "\t}\n"
+        "\t//the smallest direction completes a right handed basis, a reflection in mat moves into the smallest axis of stretch\n"
+        "\tfloat c[3] = {\n"
+        "\t\tu[1][1] * u[2][2] - u[1][2] * u[2][1],\n"
+        "\t\tu[1][2] * u[2][0] - u[1][0] * u[2][2],\n"
+        "\t\tu[1][0] * u[2][1] - u[1][1] * u[2][0],\n"
+        "\t};\n"
+        "\tmemcpy(u[0], c, sizeof(c));\n"
+        "\tfor(int i = 0; i < 3; i++) {\n"
+        "\t\tfor(int j = 0; j < 3; j++) {\n"
+        "\t\t\trotation[i][j] = u[0][i] * v[j][0] + u[1][i] * v[j][1] + u[2][i] * v[j][2];\n"
+        "\t\t}\n"
+        "\t}\n"
+        "\tfor(int i = 0; i < 3; i++) {\n"
+        "\t\tfor(int j = 0; j < 3; j++) {\n"
+        "\t\t\trtm[i][j] = rotation[0][i] * mat[0][j] + rotation[1][i] * mat[1][j] + rotation[2][i] * mat[2][j];\n"
+        "\t\t}\n"
+        "\t}\n"
+        "\tfor(int i = 0; i < 3; i++) {\n"
+        "\t\tfor(int j = 0; j < 3; j++) {\n"
+        "\t\t\tstretch[i][j] = 0.5f * (rtm[i][j] + rtm[j][i]);\n"
+        "\t\t}\n"
+        "\t}\n"
+        "\tmemcpy(out_rotation, rotation, sizeof(out_rotation[0][0]) * 9);\n"
+        "\tmemcpy(out_stretch, stretch, sizeof(out_stretch[0][0]) * 9);\n"
+        "}\n",
+        m.name, m.prefix
+    );
+
+    //cost: mat^T * mat, the two largest left singular vectors, normalizing u[2] and u[1] (two lengths, projection and
+    //subtraction), the cross product, rotation, rotation^T * mat and its symmetric part. the rank one fallback is not counted
+    FuncCost cost = {
+        .muls = 27 + 18 + (3 + 3 + 3 + 3) + 6 + 27 + 27 + 9,
+        .adds = 18 + 12 + (2 + 2 + 3 + 2) + 3 + 18 + 18 + 9,
+        .divs = 6,
+        .sqrts = 2,
+        .load_bytes = (int)sizeof(float) * 9,
+        .store_bytes = (int)sizeof(float) * 18,
+    };
+    cost_add_call(&cost, 1, "%s_eigen_symmetric", m.prefix);
+    register_cost(cost, "%s_polar_decompose", m.prefix);
+}
+
+static void print_eigen_symmetric_batch(FileData f, MatData m) {
+    if(m.dim.rows != 3 || m.dim.cols != 3) {
+        return;
+    }
+
+    //header
+    fprintf(f.header,
+        "void hf_%s_eigen_symmetric_batch(%s* mats, float (*out_values)[3], %s* out_vectors, size_t count);\n",
+        m.prefix, m.name, m.name
+    );
+
+    //source
+    fprintf(f.source,
+        "\n"
+        "void hf_%s_eigen_symmetric_batch(%s* mats, float (*out_values)[3], %s* out_vectors, size_t count) {\n",
+        m.prefix, m.name, m.name
+    );
+    print_profile_hook(f, "count", "%s_eigen_symmetric_batch", m.prefix);
+    fprintf(f.source,
+        "\tfor(size_t i = 0; i < count; i++) {\n"
+        "\t\thf_%s_eigen_symmetric(mats[i], out_values[i], out_vectors[i]);\n"
+        "\t}\n"
+        "}\n",
+        m.prefix
+    );
+
+    //cost
+    FuncCost cost = { .batched = true };
+    cost_add_call(&cost, 1, "%s_eigen_symmetric", m.prefix);
+    register_cost(cost, "%s_eigen_symmetric_batch", m.prefix);
+}
+
+static void print_polar_decompose_batch(FileData f, MatData m) {
+    if(m.dim.rows != 3 || m.dim.cols != 3) {
+        return;
+    }
+
+    //header
+    fprintf(f.header,
+        "void hf_%s_polar_decompose_batch(%s* mats, %s* out_rotations, %s* out_stretches, size_t count);\n",
+        m.prefix, m.name, m.name, m.name
+    );
+
+    //source
+    fprintf(f.source,
+        "\n"
+        "void hf_%s_polar_decompose_batch(%s* mats, %s* out_rotations, %s* out_stretches, size_t count) {\n",
+        m.prefix, m.name, m.name, m.name
+    );
+    print_profile_hook(f, "count", "%s_polar_decompose_batch", m.prefix);
+    fprintf(f.source,
+        "\tfor(size_t i = 0; i < count; i++) {\n"
+        "\t\thf_%s_polar_decompose(mats[i], out_rotations[i], out_stretches[i]);\n"
+        "\t}\n"
+        "}\n",
+        m.prefix
+    );
+
+    //cost
+    FuncCost cost = { .batched = true };
+    cost_add_call(&cost, 1, "%s_polar_decompose", m.prefix);
+    register_cost(cost, "%s_polar_decompose_batch", m.prefix);
+}
+
+//emits the body of an affine 4x4 product into tmp, the last row of both operands is assumed to be 0 0 0 1
+static void print_affine_product(FileData f, const char* indent, const char* a, const char* b) {
+    for(int i = 0; i < 3; i++) {
+        for(int j = 0; j < 4; j++) {
+            fprintf(f.source, "%stmp[%d][%d] = %s[%d][0] * %s[0][%d] + %s[%d][1] * %s[1][%d] + %s[%d][2] * %s[2][%d]",
+                indent, i, j, a, i, b, j, a, i, b, j, a, i, b, j
+            );
+            if(j == 3) {//translation
+                fprintf(f.source, " + %s[%d][3]", a, i);
+            }
+            fprintf(f.source, ";\n");
+        }
+    }
+    fprintf(f.source,
+        "%stmp[3][0] = 0.f;\n"
+        "%stmp[3][1] = 0.f;\n"
+        "%stmp[3][2] = 0.f;\n"
+        "%stmp[3][3] = 1.f;\n",
+        indent, indent, indent, indent
+    );
+}
+
+static void print_multiply_affine(FileData f, MatData m) {
+    if(m.dim.rows != 4 || m.dim.cols != 4) {
+        return;
+    }
+
+    //header
+    fprintf(f.header,
+        "void hf_%s_multiply_%s_affine(%s a, %s b, %s out);\n",
+        m.prefix, m.prefix, m.name, m.name, m.name
+    );
+
+    //source
+    fprintf(f.source,
+        "\n"
+        "void hf_%s_multiply_%s_affine(%s a, %s b, %s out) {\n",
+        m.prefix, m.prefix, m.name, m.name, m.name
+    );
+    print_profile_hook(f, "1", "%s_multiply_%s_affine", m.prefix, m.prefix);
+    fprintf(f.source, "\t%s tmp;\n", m.name);
+    print_affine_product(f, "\t", "a", "b");
+    fprintf(f.source,
+        "\tmemcpy(out, tmp, sizeof(out[0][0]) * 16);\n"
+        "}\n"
+    );
+
+    //cost
+    FuncCost cost = {
+        .muls = 36,
+        .adds = 27,
+        .load_bytes = (int)sizeof(float) * 24,
+        .store_bytes = (int)sizeof(float) * 16,
+    };
+    register_cost(cost, "%s_multiply_%s_affine", m.prefix, m.prefix);
+}
+
+static void print_multiply_affine_batch(FileData f, MatData m) {
+    if(m.dim.rows != 4 || m.dim.cols != 4) {
+        return;
+    }
+
+    //header
+    fprintf(f.header,
+        "void hf_%s_multiply_%s_affine_batch(%s* a, int* a_indices, %s* b, %s* out, size_t count);\n",
+        m.prefix, m.prefix, m.name, m.name, m.name
+    );
+
+    //source, out[i] = a[a_indices[i]] * b[i] (a[i] when a_indices is NULL)
+    //elements are processed in order, so a may alias out as long as each index points to an element already written
+    fprintf(f.source,
+        "\n"
+        "void hf_%s_multiply_%s_affine_batch(%s* a, int* a_indices, %s* b, %s* out, size_t count) {\n",
+        m.prefix, m.prefix, m.name, m.name, m.name
+    );
+    print_profile_hook(f, "count", "%s_multiply_%s_affine_batch", m.prefix, m.prefix);
+    fprintf(f.source,
+        "\tfor(size_t n = 0; n < count; n++) {\n"
+        "\t\tfloat (*lhs)[4] = a[a_indices != NULL ? (size_t)a_indices[n] : n];\n"
+        "\t\tfloat (*rhs)[4] = b[n];\n"
+        "\t\t%s tmp;\n",
+        m.name
+    );
+    print_affine_product(f, "\t\t", "lhs", "rhs");
+    fprintf(f.source,
+        "\t\tmemcpy(out[n], tmp, sizeof(tmp));\n"
+        "\t}\n"
+        "}\n"
+    );
+
+    //cost
+    FuncCost cost = {
+        .muls = 36,
+        .adds = 27,
+        .load_bytes = (int)sizeof(float) * 24 + (int)sizeof(int),
+        .store_bytes = (int)sizeof(float) * 16,
+        .batched = true,
+    };
+    register_cost(cost, "%s_multiply_%s_affine_batch", m.prefix, m.prefix);
 }
 
 static void print_typedef(FileData f, MatData m) {
@@ -383,6 +840,10 @@ static void print_functions(FileData f, MatData m) {
     print_determinant(f, m);
     print_minor(f, m);
     print_inverse(f, m);
+    print_eigen_symmetric(f, m);
+    print_polar_decompose(f, m);
+    print_eigen_symmetric_batch(f, m);
+    print_polar_decompose_batch(f, m);
 
     print_add(f, m);
     print_scalar(f, m);
@@ -394,24 +855,32 @@ static void print_functions(FileData f, MatData m) {
             print_multiply(f, m, b);
         }
     }
+    print_multiply_affine(f, m);
+    print_multiply_affine_batch(f, m);
     fprintf(f.header, "\n");
 }
 
-void create_mat(void) {
+void create_mat(bool profile) {
     FILE* header = fopen("./hf_mat.h", "w");
     fprintf(header,
         "#ifndef HF_MAT_H\n"
         "#define HF_MAT_H\n"
         "\n"
+        "#include <stddef.h>\n"
+        "\n"
     );
 
     FILE* source = fopen("./hf_mat.c", "w");
     fprintf(source,
         "#include \"../include/hf_mat.h\"\n\n"
         "#include <string.h>\n"
+        "#include <math.h>\n"
     );
+    if(profile) {
+        fprintf(source, "\n#include \"../include/hf_profile.h\"\n");
+    }
 
-    FileData file_data = { header, source };
+    FileData file_data = { header, source, profile };
 
     size_t num_mats = sizeof(matrix_dims) / sizeof(MatDims);
     for(size_t i = 0; i < num_mats; i++) {
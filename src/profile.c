@@ -0,0 +1,241 @@
+#include <stdio.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdlib.h>
+
+#include "shared.h"
+
+#define MAX_PROFILED_FUNCTIONS 1024
+
+//names (without the hf_ prefix) of every function that received a hook, in emission order
+static char profiled_names[MAX_PROFILED_FUNCTIONS][64];
+static size_t profiled_count = 0;
+
+void print_profile_hook(FileData f, const char* elements, const char* format, ...) {
+    if(!f.profile) {
+        return;
+    }
+    if(profiled_count >= MAX_PROFILED_FUNCTIONS) {
+        fprintf(stderr, "profile: more than %d hooked functions, raise MAX_PROFILED_FUNCTIONS\n", MAX_PROFILED_FUNCTIONS);
+        exit(1);
+    }
+
+    char* name = profiled_names[profiled_count++];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(name, sizeof(profiled_names[0]), format, args);
+    va_end(args);
+
+    fprintf(f.source, "\tHF_PROFILE(hf_profile_id_%s, %s);\n", name, elements);
+}
+
+static void print_ids(FileData f) {
+    fprintf(f.header, "typedef enum hf_profile_id_e {\n");
+    for(size_t i = 0; i < profiled_count; i++) {
+        fprintf(f.header, "\thf_profile_id_%s,\n", profiled_names[i]);
+    }
+    fprintf(f.header,
+        "\thf_profile_id_count\n"
+        "} hf_profile_id;\n"
+    );
+
+    fprintf(f.source, "\nstatic const char* names[] = {\n");
+    for(size_t i = 0; i < profiled_count; i++) {
+        fprintf(f.source, "\t\"hf_%s\",\n", profiled_names[i]);
+    }
+    fprintf(f.source, "};\n");
+}
+
+static void print_hook(FileData f) {
+    //the hook compiles to nothing unless HF_PROFILE_ENABLE is defined
+    //with HF_PROFILE_CYCLES on gcc/clang x86 it also accumulates inclusive rdtsc cycles through a cleanup scope
+    fprintf(f.header,
+        "\n"
+        "typedef struct hf_profile_counter_s {\n"
+        "\tunsigned long long calls;\n"
+        "\tunsigned long long elements;\n"
+        "\tunsigned long long cycles;\n"
+        "} hf_profile_counter;\n"
+        "\n"
+        "//every thread gets its own counter block on its first hook, blocks are never freed so the counts\n"
+        "//of exited threads stay in the reports\n"
+        "typedef struct hf_profile_block_s {\n"
+        "\thf_profile_counter counters[hf_profile_id_count];\n"
+        "\tstruct hf_profile_block_s* next;\n"
+        "} hf_profile_block;\n"
+        "\n"
+        "#if defined(_MSC_VER)\n"
+        "#define HF_PROFILE_THREAD_LOCAL __declspec(thread)\n"
+        "#else\n"
+        "#define HF_PROFILE_THREAD_LOCAL __thread\n"
+        "#endif\n"
+        "\n"
+        "//block of the calling thread, NULL until its first hook\n"
+        "extern HF_PROFILE_THREAD_LOCAL hf_profile_block* hf_profile_local;\n"
+        "hf_profile_block* hf_profile_register(void);\n"
+        "\n"
+        "static inline hf_profile_counter* hf_profile_count(hf_profile_id id, unsigned long long n) {\n"
+        "\thf_profile_block* block = hf_profile_local != NULL ? hf_profile_local : hf_profile_register();\n"
+        "\thf_profile_counter* counter = &block->counters[id];\n"
+        "\tcounter->calls++;\n"
+        "\tcounter->elements += n;\n"
+        "\treturn counter;\n"
+        "}\n"
+        "\n"
+        "#if !defined(HF_PROFILE_ENABLE)\n"
+        "#define HF_PROFILE(id, n) ((void)0)\n"
+        "#elif defined(HF_PROFILE_CYCLES) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))\n"
+        "#include <x86intrin.h>\n"
+        "typedef struct hf_profile_scope_s {\n"
+        "\thf_profile_counter* counter;\n"
+        "\tunsigned long long start;\n"
+        "} hf_profile_scope;\n"
+        "static inline void hf_profile_scope_end(hf_profile_scope* scope) {\n"
+        "\tscope->counter->cycles += __rdtsc() - scope->start;\n"
+        "}\n"
+        "#define HF_PROFILE(id, n) \\\n"
+        "\thf_profile_counter* hf_profile_c = hf_profile_count((id), (unsigned long long)(n)); \\\n"
+        "\thf_profile_scope hf_profile_s __attribute__((cleanup(hf_profile_scope_end))) = { hf_profile_c, __rdtsc() }\n"
+        "#else\n"
+        "#define HF_PROFILE(id, n) ((void)hf_profile_count((id), (unsigned long long)(n)))\n"
+        "#endif\n"
+        "\n"
+    );
+}
+
+static void print_api(FileData f) {
+    fprintf(f.header,
+        "//reports and reset cover the blocks of every thread, they are not synchronized with threads\n"
+        "//still running hooks, so counts read while those run may be torn or slightly stale\n"
+        "const char* hf_profile_name(hf_profile_id id);\n"
+        "void hf_profile_reset(void);\n"
+        "void hf_profile_dump(FILE* out);\n"
+        "void hf_profile_dump_json(FILE* out);\n"
+    );
+
+    fprintf(f.source,
+        "\n"
+        "#if defined(_MSC_VER)\n"
+        "#include <intrin.h>\n"
+        "#define HF_PROFILE_CAS(ptr, old, new) (_InterlockedCompareExchangePointer((void* volatile*)(ptr), (new), (old)) == (old))\n"
+        "#else\n"
+        "#define HF_PROFILE_CAS(ptr, old, new) __sync_bool_compare_and_swap((ptr), (old), (new))\n"
+        "#endif\n"
+        "\n"
+        "HF_PROFILE_THREAD_LOCAL hf_profile_block* hf_profile_local = NULL;\n"
+        "static hf_profile_block* volatile blocks = NULL;\n"
+        "\n"
+        "hf_profile_block* hf_profile_register(void) {\n"
+        "\thf_profile_block* block = calloc(1, sizeof(hf_profile_block));\n"
+        "\tif(block == NULL) {\n"
+        "\t\tfprintf(stderr, \"hf_profile: could not allocate the counters of a thread\\n\");\n"
+        "\t\tabort();\n"
+        "\t}\n"
+        "\tdo {\n"
+        "\t\tblock->next = blocks;\n"
+        "\t} while(!HF_PROFILE_CAS(&blocks, block->next, block));\n"
+        "\thf_profile_local = block;\n"
+        "\treturn block;\n"
+        "}\n"
+        "\n"
+        "const char* hf_profile_name(hf_profile_id id) {\n"
+        "\treturn names[id];\n"
+        "}\n"
+        "\n"
+        "void hf_profile_reset(void) {\n"
+        "\tfor(hf_profile_block* block = blocks; block != NULL; block = block->next) {\n"
+        "\t\tmemset(block->counters, 0, sizeof(block->counters));\n"
+        "\t}\n"
+        "}\n"
+        "\n"
+        "typedef struct entry_s {\n"
+        "\tint id;\n"
+        "\thf_profile_counter total;\n"
+        "} entry;\n"
+        "\n"
+        "static int compare(const void* a, const void* b) {\n"
+        "\tconst entry* ea = a;\n"
+        "\tconst entry* eb = b;\n"
+        "\tif(ea->total.cycles != eb->total.cycles) {\n"
+        "\t\treturn ea->total.cycles < eb->total.cycles ? 1 : -1;\n"
+        "\t}\n"
+        "\tif(ea->total.calls != eb->total.calls) {\n"
+        "\t\treturn ea->total.calls < eb->total.calls ? 1 : -1;\n"
+        "\t}\n"
+        "\treturn ea->id - eb->id;\n"
+        "}\n"
+        "\n"
+        "//sums the blocks of every thread into entries, keeps the called functions most expensive first and returns how many there are\n"
+        "static int sorted_entries(entry* entries) {\n"
+        "\tint count = 0;\n"
+        "\tfor(int i = 0; i < hf_profile_id_count; i++) {\n"
+        "\t\thf_profile_counter total = { 0, 0, 0 };\n"
+        "\t\tfor(hf_profile_block* block = blocks; block != NULL; block = block->next) {\n"
+        "\t\t\ttotal.calls += block->counters[i].calls;\n"
+        "\t\t\ttotal.elements += block->counters[i].elements;\n"
+        "\t\t\ttotal.cycles += block->counters[i].cycles;\n"
+        "\t\t}\n"
+        "\t\tif(total.calls > 0) {\n"
+        "\t\t\tentries[count].id = i;\n"
+        "\t\t\tentries[count].total = total;\n"
+        "\t\t\tcount++;\n"
+        "\t\t}\n"
+        "\t}\n"
+        "\tqsort(entries, (size_t)count, sizeof(entries[0]), compare);\n"
+        "\treturn count;\n"
+        "}\n"
+        "\n"
+        "void hf_profile_dump(FILE* out) {\n"
+        "\tentry entries[hf_profile_id_count];\n"
+        "\tint count = sorted_entries(entries);\n"
+        "\tfprintf(out, \"%%-40s %%16s %%16s %%20s\\n\", \"function\", \"calls\", \"elements\", \"cycles\");\n"
+        "\tfor(int i = 0; i < count; i++) {\n"
+        "\t\thf_profile_counter c = entries[i].total;\n"
+        "\t\tfprintf(out, \"%%-40s %%16llu %%16llu %%20llu\\n\", names[entries[i].id], c.calls, c.elements, c.cycles);\n"
+        "\t}\n"
+        "}\n"
+        "\n"
+        "void hf_profile_dump_json(FILE* out) {\n"
+        "\tentry entries[hf_profile_id_count];\n"
+        "\tint count = sorted_entries(entries);\n"
+        "\tfprintf(out, \"[\");\n"
+        "\tfor(int i = 0; i < count; i++) {\n"
+        "\t\thf_profile_counter c = entries[i].total;\n"
+        "\t\tfprintf(out, \"%%s\\n\\t{ \\\"name\\\": \\\"%%s\\\", \\\"calls\\\": %%llu, \\\"elements\\\": %%llu, \\\"cycles\\\": %%llu }\",\n"
+        "\t\t\ti == 0 ? \"\" : \",\", names[entries[i].id], c.calls, c.elements, c.cycles);\n"
+        "\t}\n"
+        "\tfprintf(out, \"\\n]\\n\");\n"
+        "}\n"
+    );
+}
+
+void create_profile(void) {
+    FILE* header = fopen("./hf_profile.h", "w");
+    fprintf(header,
+        "#ifndef HF_PROFILE_H\n"
+        "#define HF_PROFILE_H\n"
+        "\n"
+        "#include <stdio.h>\n"
+        "\n"
+    );
+
+    FILE* source = fopen("./hf_profile.c", "w");
+    fprintf(source,
+        "#include \"../include/hf_profile.h\"\n\n"
+        "#include <stdlib.h>\n"
+        "#include <string.h>\n"
+    );
+
+    FileData file_data = { header, source, true };
+
+    print_ids(file_data);
+    print_hook(file_data);
+    print_api(file_data);
+
+    fprintf(header,
+        "\n#endif//HF_PROFILE_H\n"
+    );
+
+    fclose(header);
+    fclose(source);
+}
@@ -1,9 +1,42 @@
 #ifndef SHARED_H
 #define SHARED_H
 
+#include <stdbool.h>
+
 typedef struct FileData_s {
     FILE* header;
     FILE* source;
+    bool profile;
 } FileData;
 
+//emits the HF_PROFILE hook for a function whose name (without the hf_ prefix) is given by format, when profiling is enabled
+void print_profile_hook(FileData f, const char* elements, const char* format, ...);
+
+#define MAX_COST_CALLS 4
+
+typedef struct FuncCall_s {
+    char name[64];
+    int count;
+} FuncCall;
+
+//static cost of one call to a generated function, not counting the functions it calls
+//memory traffic is the bytes read from arguments and written to outputs, locals are assumed to live in registers
+typedef struct FuncCost_s {
+    int muls;
+    int adds;
+    int divs;
+    int sqrts;
+    int load_bytes;
+    int store_bytes;
+    bool batched;//costs are per element instead of per call
+
+    FuncCall calls[MAX_COST_CALLS];
+    int call_count;
+} FuncCost;
+
+//records that cost calls the function (without the hf_ prefix) given by format count times
+void cost_add_call(FuncCost* cost, int count, const char* format, ...);
+//registers the cost of the function (without the hf_ prefix) given by format for the manifest
+void register_cost(FuncCost cost, const char* format, ...);
+
 #endif//SHARED_H
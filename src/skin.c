@@ -0,0 +1,190 @@
+#include <stdio.h>
+#include <stddef.h>
+
+#include "shared.h"
+
+#define SKIN_INFLUENCES 4
+
+//bones are assumed affine, so only the first 3 rows of the palette matrices are blended
+#define SKIN_ROWS 3
+
+//indices, weights, the blended palette rows, position and normal
+#define SKIN_LOAD_BYTES ((int)(SKIN_INFLUENCES * (sizeof(int) + sizeof(float)) + SKIN_INFLUENCES * SKIN_ROWS * 4 * sizeof(float) + 6 * sizeof(float)))
+#define SKIN_STORE_BYTES ((int)(6 * sizeof(float)))
+
+static void print_vertex(FileData f) {
+    //header
+    fprintf(f.header,
+        "void hf_skin_vertex(hf_mat4f* palette, hf_vec4i indices, hf_vec4f weights, hf_vec3f position, hf_vec3f normal, hf_vec3f out_position, hf_vec3f out_normal);\n"
+    );
+
+    //source
+    fprintf(f.source,
+        "\n"
+        "void hf_skin_vertex(hf_mat4f* palette, hf_vec4i indices, hf_vec4f weights, hf_vec3f position, hf_vec3f normal, hf_vec3f out_position, hf_vec3f out_normal) {\n"
+    );
+    print_profile_hook(f, "1", "skin_vertex");
+    for(int i = 0; i < SKIN_INFLUENCES; i++) {
+        fprintf(f.source, "\tfloat (*b%d)[4] = palette[indices[%d]];\n", i, i);
+    }
+
+    //blend palette rows into locals
+    for(int row = 0; row < SKIN_ROWS; row++) {
+        for(int col = 0; col < 4; col++) {
+            fprintf(f.source, "\tfloat m%d%d =", row, col);
+            for(int i = 0; i < SKIN_INFLUENCES; i++) {
+                fprintf(f.source, " weights[%d] * b%d[%d][%d]", i, i, row, col);
+                if(i < (SKIN_INFLUENCES - 1)) {
+                    fprintf(f.source, " +");
+                }
+            }
+            fprintf(f.source, ";\n");
+        }
+    }
+
+    //read inputs before writing, so outputs can alias them
+    fprintf(f.source,
+        "\tfloat px = position[0], py = position[1], pz = position[2];\n"
+        "\tfloat nx = normal[0], ny = normal[1], nz = normal[2];\n"
+    );
+    for(int row = 0; row < SKIN_ROWS; row++) {
+        fprintf(f.source, "\tout_position[%d] = m%d0 * px + m%d1 * py + m%d2 * pz + m%d3;\n", row, row, row, row, row);
+    }
+    for(int row = 0; row < SKIN_ROWS; row++) {
+        fprintf(f.source, "\tout_normal[%d] = m%d0 * nx + m%d1 * ny + m%d2 * nz;\n", row, row, row, row);
+    }
+    fprintf(f.source, "}\n");
+
+    //cost
+    FuncCost cost = {
+        .muls = SKIN_ROWS * 4 * SKIN_INFLUENCES + SKIN_ROWS * 3 * 2,
+        .adds = SKIN_ROWS * 4 * (SKIN_INFLUENCES - 1) + SKIN_ROWS * 3 + SKIN_ROWS * 2,
+        .load_bytes = SKIN_LOAD_BYTES,
+        .store_bytes = SKIN_STORE_BYTES,
+    };
+    register_cost(cost, "skin_vertex");
+}
+
+static void print_vertex_simd(FileData f) {
+    //header
+    fprintf(f.header,
+        "void hf_skin_vertex_simd(hf_mat4f* palette, hf_vec4i indices, hf_vec4f weights, hf_vec3f position, hf_vec3f normal, hf_vec3f out_position, hf_vec3f out_normal);\n"
+    );
+
+    //source, falls back to the scalar path when SSE is unavailable
+    fprintf(f.source,
+        "\n"
+        "void hf_skin_vertex_simd(hf_mat4f* palette, hf_vec4i indices, hf_vec4f weights, hf_vec3f position, hf_vec3f normal, hf_vec3f out_position, hf_vec3f out_normal) {\n"
+    );
+    print_profile_hook(f, "1", "skin_vertex_simd");
+    fprintf(f.source, "#if defined(HF_SKIN_SSE)\n");
+    for(int i = 0; i < SKIN_INFLUENCES; i++) {
+        fprintf(f.source, "\t__m128 w%d = _mm_set1_ps(weights[%d]);\n", i, i);
+    }
+    for(int row = 0; row < SKIN_ROWS; row++) {
+        fprintf(f.source, "\t__m128 r%d = _mm_mul_ps(w0, _mm_loadu_ps(palette[indices[0]][%d]));\n", row, row);
+        for(int i = 1; i < SKIN_INFLUENCES; i++) {
+            fprintf(f.source, "\tr%d = _mm_add_ps(r%d, _mm_mul_ps(w%d, _mm_loadu_ps(palette[indices[%d]][%d])));\n", row, row, i, i, row);
+        }
+    }
+    fprintf(f.source,
+        "\t__m128 p = _mm_setr_ps(position[0], position[1], position[2], 1.f);\n"
+        "\t__m128 n = _mm_setr_ps(normal[0], normal[1], normal[2], 0.f);\n"
+        "\t__m128 p0 = _mm_mul_ps(r0, p), p1 = _mm_mul_ps(r1, p), p2 = _mm_mul_ps(r2, p), p3 = _mm_setzero_ps();\n"
+        "\t__m128 n0 = _mm_mul_ps(r0, n), n1 = _mm_mul_ps(r1, n), n2 = _mm_mul_ps(r2, n), n3 = _mm_setzero_ps();\n"
+        "\t_MM_TRANSPOSE4_PS(p0, p1, p2, p3);\n"
+        "\t_MM_TRANSPOSE4_PS(n0, n1, n2, n3);\n"
+        "\tfloat res_p[4], res_n[4];\n"
+        "\t_mm_storeu_ps(res_p, _mm_add_ps(_mm_add_ps(p0, p1), _mm_add_ps(p2, p3)));\n"
+        "\t_mm_storeu_ps(res_n, _mm_add_ps(_mm_add_ps(n0, n1), _mm_add_ps(n2, n3)));\n"
+    );
+    for(int row = 0; row < SKIN_ROWS; row++) {
+        fprintf(f.source, "\tout_position[%d] = res_p[%d];\n", row, row);
+    }
+    for(int row = 0; row < SKIN_ROWS; row++) {
+        fprintf(f.source, "\tout_normal[%d] = res_n[%d];\n", row, row);
+    }
+    fprintf(f.source,
+        "#else\n"
+        "\thf_skin_vertex(palette, indices, weights, position, normal, out_position, out_normal);\n"
+        "#endif\n"
+        "}\n"
+    );
+
+    //cost of the SSE path, counted per lane
+    FuncCost cost = {
+        .muls = SKIN_ROWS * 4 * SKIN_INFLUENCES + SKIN_ROWS * 4 * 2,
+        .adds = SKIN_ROWS * 4 * (SKIN_INFLUENCES - 1) + 3 * 4 * 2,
+        .load_bytes = SKIN_LOAD_BYTES,
+        .store_bytes = SKIN_STORE_BYTES,
+    };
+    register_cost(cost, "skin_vertex_simd");
+}
+
+static void print_batch(FileData f) {
+    //header
+    fprintf(f.header,
+        "void hf_skin_batch(hf_mat4f* palette, hf_vec4i* indices, hf_vec4f* weights, hf_vec3f* positions, hf_vec3f* normals, hf_vec3f* out_positions, hf_vec3f* out_normals, size_t count);\n"
+    );
+
+    //source
+    fprintf(f.source,
+        "\n"
+        "void hf_skin_batch(hf_mat4f* palette, hf_vec4i* indices, hf_vec4f* weights, hf_vec3f* positions, hf_vec3f* normals, hf_vec3f* out_positions, hf_vec3f* out_normals, size_t count) {\n"
+    );
+    print_profile_hook(f, "count", "skin_batch");
+    fprintf(f.source,
+        "\tfor(size_t i = 0; i < count; i++) {\n"
+        "\t\thf_skin_vertex_simd(palette, indices[i], weights[i], positions[i], normals[i], out_positions[i], out_normals[i]);\n"
+        "\t}\n"
+        "}\n"
+    );
+
+    //cost
+    FuncCost cost = { .batched = true };
+    cost_add_call(&cost, 1, "skin_vertex_simd");
+    register_cost(cost, "skin_batch");
+}
+
+void create_skin(bool profile) {
+    FILE* header = fopen("./hf_skin.h", "w");
+    fprintf(header,
+        "#ifndef HF_SKIN_H\n"
+        "#define HF_SKIN_H\n"
+        "\n"
+        "#include <stddef.h>\n"
+        "\n"
+        "#include \"hf_mat.h\"\n"
+        "#include \"hf_vec.h\"\n"
+        "\n"
+        "//linear blend skinning, %d influences per vertex. palette bones are assumed affine (last row 0 0 0 1)\n"
+        "//and output normals are not renormalized\n",
+        SKIN_INFLUENCES
+    );
+
+    FILE* source = fopen("./hf_skin.c", "w");
+    fprintf(source,
+        "#include \"../include/hf_skin.h\"\n\n"
+        "//msvc never defines __SSE__, on x64 SSE is always available\n"
+        "#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)\n"
+        "#define HF_SKIN_SSE\n"
+        "#include <xmmintrin.h>\n"
+        "#endif\n"
+    );
+    if(profile) {
+        fprintf(source, "\n#include \"../include/hf_profile.h\"\n");
+    }
+
+    FileData file_data = { header, source, profile };
+
+    print_vertex(file_data);
+    print_vertex_simd(file_data);
+    print_batch(file_data);
+
+    fprintf(header,
+        "\n#endif//HF_SKIN_H\n"
+    );
+
+    fclose(header);
+    fclose(source);
+}
@@ -26,7 +26,7 @@ typedef struct vec_data_s {
 static vec_data vec_data_create(vec_def def) {
     vec_data out;
 
-    char type_suffix[32];
+    char type_suffix[4];
     switch(def.type) {
         case vec_type_float:
             strcpy(type_suffix, "f");
@@ -48,6 +48,17 @@ static vec_data vec_data_create(vec_def def) {
     return out;
 }
 
+static int type_size(vec_data v) {
+    switch(v.def.type) {
+        case vec_type_double:
+            return (int)sizeof(double);
+        case vec_type_float:
+            return (int)sizeof(float);
+        default:
+            return (int)sizeof(int);
+    }
+}
+
 static vec_def defs[] = {
     { vec_type_int, 2 },
     { vec_type_float, 2 },
@@ -72,50 +83,79 @@ static void print_copy(FileData f, vec_data v) {
 
     //copy source
     fprintf(f.source, "\nvoid hf_%s_copy(%s* restrict vec, %s out) {\n", v.prefix, v.type, v.name);
+    print_profile_hook(f, "1", "%s_copy", v.prefix);
     for (int i = 0; i < v.def.components; i++) {
         fprintf(f.source, "\tout[%d] = vec[%d];\n", i, i);
     }
     fprintf(f.source, "}\n");
+
+    //cost
+    int bytes = type_size(v) * v.def.components;
+    register_cost((FuncCost) { .load_bytes = bytes, .store_bytes = bytes }, "%s_copy", v.prefix);
 }
 
 static void print_add(FileData f, vec_data v) {
     fprintf(f.header, "void hf_%s_add(%s a, %s b, %s out);\n", v.prefix, v.name, v.name, v.name);
 
     fprintf(f.source, "\nvoid hf_%s_add(%s a, %s b, %s out) {\n", v.prefix, v.name, v.name, v.name);
+    print_profile_hook(f, "1", "%s_add", v.prefix);
     for(int i = 0; i < v.def.components; i++) {
         fprintf(f.source, "\tout[%d] = a[%d] + b[%d];\n", i, i, i);
     }
     fprintf(f.source, "}\n");
+
+    //cost
+    int n = v.def.components;
+    int bytes = type_size(v) * n;
+    register_cost((FuncCost) { .adds = n, .load_bytes = bytes * 2, .store_bytes = bytes }, "%s_add", v.prefix);
 }
 
 static void print_subtract(FileData f, vec_data v) {
     fprintf(f.header, "void hf_%s_subtract(%s a, %s b, %s out);\n", v.prefix, v.name, v.name, v.name);
 
     fprintf(f.source, "\nvoid hf_%s_subtract(%s a, %s b, %s out) {\n", v.prefix, v.name, v.name, v.name);
+    print_profile_hook(f, "1", "%s_subtract", v.prefix);
     for(int i = 0; i < v.def.components; i++) {
         fprintf(f.source, "\tout[%d] = a[%d] - b[%d];\n", i, i, i);
     }
     fprintf(f.source, "}\n");
+
+    //cost
+    int n = v.def.components;
+    int bytes = type_size(v) * n;
+    register_cost((FuncCost) { .adds = n, .load_bytes = bytes * 2, .store_bytes = bytes }, "%s_subtract", v.prefix);
 }
 
 static void print_multiply(FileData f, vec_data v) {
     fprintf(f.header, "void hf_%s_multiply(%s vec, %s scalar, %s out);\n", v.prefix, v.name, v.type, v.name);
 
     fprintf(f.source, "\nvoid hf_%s_multiply(%s vec, %s scalar, %s out) {\n", v.prefix, v.name, v.type, v.name);
+    print_profile_hook(f, "1", "%s_multiply", v.prefix);
     for(int i = 0; i < v.def.components; i++) {
         fprintf(f.source, "\tout[%d] = vec[%d] * scalar;\n", i, i);
     }
     fprintf(f.source, "}\n");
+
+    //cost
+    int n = v.def.components;
+    int bytes = type_size(v) * n;
+    register_cost((FuncCost) { .muls = n, .load_bytes = bytes, .store_bytes = bytes }, "%s_multiply", v.prefix);
 }
 
 static void print_divide(FileData f, vec_data v) {
     fprintf(f.header, "void hf_%s_divide(%s vec, %s scalar, %s out);\n", v.prefix, v.name, v.type, v.name);
 
     fprintf(f.source, "\nvoid hf_%s_divide(%s vec, %s scalar, %s out) {\n", v.prefix, v.name, v.type, v.name);
+    print_profile_hook(f, "1", "%s_divide", v.prefix);
     for(int i = 0; i < v.def.components; i++) {
         fprintf(f.source, "\tout[%d] = vec[%d] / scalar;\n", i, i);
     }
     fprintf(f.source, "}\n");
+
+    //cost
+    int n = v.def.components;
+    int bytes = type_size(v) * n;
+    register_cost((FuncCost) { .divs = n, .load_bytes = bytes, .store_bytes = bytes }, "%s_divide", v.prefix);
 }
 
 static void print_normalize(FileData f, vec_data v) {
@@ -129,8 +169,15 @@ static void print_normalize(FileData f, vec_data v) {
     fprintf(f.header, "void hf_%s_normalize(%s vec, %s out);\n", v.prefix, v.name, v.name);
 
     fprintf(f.source, "\nvoid hf_%s_normalize(%s vec, %s out) {\n", v.prefix, v.name, v.name);
+    print_profile_hook(f, "1", "%s_normalize", v.prefix);
     fprintf(f.source, "\thf_%s_divide(vec, hf_%s_magnitude(vec), out);\n", v.prefix, v.prefix);
     fprintf(f.source, "}\n");
+
+    //cost
+    FuncCost cost = { 0 };
+    cost_add_call(&cost, 1, "%s_magnitude", v.prefix);
+    cost_add_call(&cost, 1, "%s_divide", v.prefix);
+    register_cost(cost, "%s_normalize", v.prefix);
 }
 
 static void print_lerp(FileData f, vec_data v) {
@@ -146,16 +193,23 @@ static void print_lerp(FileData f, vec_data v) {
     fprintf(f.header, "void hf_%s_lerp(%s a, %s b, %s t, %s out);\n", v.prefix, v.name, v.name, v.type, v.name);
 
     fprintf(f.source, "\nvoid hf_%s_lerp(%s a, %s b, %s t, %s out) {\n", v.prefix, v.name, v.name, v.type, v.name);
+    print_profile_hook(f, "1", "%s_lerp", v.prefix);
     for(int i = 0; i < v.def.components; i++) {
         fprintf(f.source, "\tout[%d] = a[%d] * (1%s - t) + b[%d] * t;\n", i, i, literal_suffix, i);
     }
     fprintf(f.source, "}\n");
+
+    //cost
+    int n = v.def.components;
+    int bytes = type_size(v) * n;
+    register_cost((FuncCost) { .muls = n * 2, .adds = n * 2, .load_bytes = bytes * 2, .store_bytes = bytes }, "%s_lerp", v.prefix);
 }
 
 static void print_sqrmag(FileData f, vec_data v) {
     fprintf(f.header, "%s hf_%s_square_magnitude(%s vec);\n", v.type, v.prefix, v.name);
 
     fprintf(f.source, "\n%s hf_%s_square_magnitude(%s vec) {\n", v.type, v.prefix, v.name);
+    print_profile_hook(f, "1", "%s_square_magnitude", v.prefix);
     fprintf(f.source, "\treturn ");
     for(int i = 0; i < v.def.components; i++) {
         fprintf(f.source, "vec[%d] * vec[%d]", i, i);
@@ -165,6 +219,11 @@ static void print_sqrmag(FileData f, vec_data v) {
     }
     fprintf(f.source, ";\n");
     fprintf(f.source, "}\n");
+
+    //cost
+    int n = v.def.components;
+    int bytes = type_size(v) * n;
+    register_cost((FuncCost) { .muls = n, .adds = n - 1, .load_bytes = bytes }, "%s_square_magnitude", v.prefix);
 }
 
 static void get_mag_strings(vec_data v, char* ret_type, char* sqr_func, char* cast) {
@@ -183,7 +242,7 @@ static void get_mag_strings(vec_data v, char* ret_type, char* sqr_func, char* ca
             sprintf(cast, "(float)");
             break;
         default:
-            sprintf(cast, "");
+            cast[0] = '\0';
             break;
     }
 }
@@ -197,18 +256,31 @@ static void print_mag(FileData f, vec_data v) {
     fprintf(f.header, "%s hf_%s_magnitude(%s vec);\n", ret_type, v.prefix, v.name);
 
     fprintf(f.source, "\n%s hf_%s_magnitude(%s vec) {\n", ret_type, v.prefix, v.name);
+    print_profile_hook(f, "1", "%s_magnitude", v.prefix);
     fprintf(f.source, "\treturn %s(%shf_%s_square_magnitude(vec));\n", sqr_func, cast, v.prefix);
     fprintf(f.source, "}\n");
+
+    //cost
+    FuncCost cost = { .sqrts = 1 };
+    cost_add_call(&cost, 1, "%s_square_magnitude", v.prefix);
+    register_cost(cost, "%s_magnitude", v.prefix);
 }
 
 static void print_sqrdist(FileData f, vec_data v) {
     fprintf(f.header, "%s hf_%s_square_distance(%s a, %s b);\n", v.type, v.prefix, v.name, v.name);
 
     fprintf(f.source, "\n%s hf_%s_square_distance(%s a, %s b) {\n", v.type, v.prefix, v.name, v.name);
+    print_profile_hook(f, "1", "%s_square_distance", v.prefix);
     fprintf(f.source, "\t%s aux;\n", v.name);
     fprintf(f.source, "\thf_%s_subtract(a, b, aux);\n", v.prefix);
     fprintf(f.source, "\treturn hf_%s_square_magnitude(aux);\n", v.prefix);
     fprintf(f.source, "}\n");
+
+    //cost
+    FuncCost cost = { 0 };
+    cost_add_call(&cost, 1, "%s_subtract", v.prefix);
+    cost_add_call(&cost, 1, "%s_square_magnitude", v.prefix);
+    register_cost(cost, "%s_square_distance", v.prefix);
 }
 
 static void print_dist(FileData f, vec_data v) {
@@ -220,14 +292,21 @@ static void print_dist(FileData f, vec_data v) {
     fprintf(f.header, "%s hf_%s_distance(%s a, %s b);\n", ret_type, v.prefix, v.name, v.name);
 
     fprintf(f.source, "\n%s hf_%s_distance(%s a, %s b) {\n", ret_type, v.prefix, v.name, v.name);
+    print_profile_hook(f, "1", "%s_distance", v.prefix);
     fprintf(f.source, "\treturn %s(%shf_%s_square_distance(a, b));\n", sqr_func, cast, v.prefix);
     fprintf(f.source, "}\n");
+
+    //cost
+    FuncCost cost = { .sqrts = 1 };
+    cost_add_call(&cost, 1, "%s_square_distance", v.prefix);
+    register_cost(cost, "%s_distance", v.prefix);
 }
 
 static void print_dot(FileData f, vec_data v) {
     fprintf(f.header, "%s hf_%s_dot(%s a, %s b);\n", v.type, v.prefix, v.name, v.name);
 
     fprintf(f.source, "\n%s hf_%s_dot(%s a, %s b) {\n", v.type, v.prefix, v.name, v.name);
+    print_profile_hook(f, "1", "%s_dot", v.prefix);
     fprintf(f.source, "\treturn ");
     for(int i = 0; i < v.def.components; i++) {
         fprintf(f.source, "a[%d] * b[%d]", i, i);
@@ -237,6 +316,11 @@ static void print_dot(FileData f, vec_data v) {
     }
     fprintf(f.source, ";\n");
     fprintf(f.source, "}\n");
+
+    //cost
+    int n = v.def.components;
+    int bytes = type_size(v) * n;
+    register_cost((FuncCost) { .muls = n, .adds = n - 1, .load_bytes = bytes * 2 }, "%s_dot", v.prefix);
 }
 
 static void print_cross(FileData f, vec_data v) {
@@ -247,12 +331,19 @@ static void print_cross(FileData f, vec_data v) {
     fprintf(f.header, "void hf_%s_cross(%s a, %s b, %s out);\n", v.prefix, v.name, v.name, v.name);
 
     fprintf(f.source, "\nvoid hf_%s_cross(%s a, %s b, %s out) {\n", v.prefix, v.name, v.name, v.name);
+    print_profile_hook(f, "1", "%s_cross", v.prefix);
     fprintf(f.source, "\t%s tmp;\n", v.name);
     for(int i = 0; i < v.def.components; i++) {
         fprintf(f.source, "\ttmp[%d] = a[%d] * b[%d] - a[%d] * b[%d];\n", i, (i + 1) % v.def.components, (i + 2) % v.def.components, (i + 2) % v.def.components, (i + 1) % v.def.components);
     }
     fprintf(f.source, "\thf_%s_copy(tmp, out);\n", v.prefix);
     fprintf(f.source, "}\n");
+
+    //cost
+    int bytes = type_size(v) * v.def.components;
+    FuncCost cost = { .muls = 6, .adds = 3, .load_bytes = bytes * 2 };
+    cost_add_call(&cost, 1, "%s_copy", v.prefix);
+    register_cost(cost, "%s_cross", v.prefix);
 }
 
 static void print_functions(FileData f, vec_data v) {
@@ -272,7 +363,7 @@ static void print_functions(FileData f, vec_data v) {
     print_cross(f, v);
 }
 
-void create_vec(void) {
+void create_vec(bool profile) {
     (void)defs;
 
     FILE* header = fopen("./hf_vec.h", "w");
@@ -287,8 +378,11 @@ void create_vec(void) {
         "#include \"../include/hf_vec.h\"\n\n"
         "#include <math.h>\n"
     );
+    if(profile) {
+        fprintf(source, "\n#include \"../include/hf_profile.h\"\n");
+    }
 
-    FileData file_data = { header, source };
+    FileData file_data = { header, source, profile };
 
     size_t count = sizeof(defs) / sizeof(defs[0]);
     for(size_t i = 0; i < count; i++) {